@@ -0,0 +1,151 @@
+#include "BotProtocol.h"
+
+#include <algorithm>
+#include <cstring>
+#include "Exceptions.h"
+
+const int BotProtocol::MaxNumRooms;
+
+const int BotRequest::MaxRooms;
+const int BotResponse::MaxEvents;
+const uint8_t BotResponse::PlayerAlive;
+const uint8_t BotResponse::WumpusAlive;
+const uint8_t BotResponse::WumpusAdjacent;
+const uint8_t BotResponse::BatsAdjacent;
+const uint8_t BotResponse::PitAdjacent;
+const uint8_t BotResponse::BadRequest;
+const uint8_t BotResponse::NotStarted;
+
+BotProtocol::BotProtocol(Commands& commands, const PlayerState& playerState, const Map& map)
+    : m_commands(commands)
+    , m_playerState(playerState)
+{
+    if (map.GetNumRooms() > MaxNumRooms)
+        throw TooManyRoomsException();
+}
+
+BotResponse BotProtocol::Handle(const BotRequest& request)
+{
+    BotResponse response = {};
+    if (request.m_op > BotOp::Restart)
+    {
+        response.m_status = BotResponse::BadRequest;
+        return response;
+    }
+
+    // Until a game is started the player is in room 0, which has no tunnels.
+    bool starting = (request.m_op == BotOp::Start || request.m_op == BotOp::Restart);
+    if (!starting && m_playerState.GetPlayerRoom() == 0)
+    {
+        response.m_status = BotResponse::NotStarted;
+        return response;
+    }
+
+    m_events.Clear();
+    Describe(Execute(request, response), response);
+    return response;
+}
+
+CommandStatus BotProtocol::Execute(const BotRequest& request, BotResponse& response)
+{
+    switch (request.m_op)
+    {
+    case BotOp::Start:
+        AddEvents(m_commands.RandomPlacements());
+        return CommandStatus::Ok;
+    case BotOp::Move:
+        return m_commands.TryMovePlayer(request.m_rooms[0], m_events);
+    case BotOp::Shoot:
+    {
+        CommandStatus status = m_commands.TryPrepareArrow(request.m_numRooms);
+        return (status == CommandStatus::Ok) ? FlyArrow(request, response) : status;
+    }
+    case BotOp::MoveArrow:
+        return FlyArrow(request, response);
+    case BotOp::Replay:
+        AddEvents(m_commands.Replay());
+        return CommandStatus::Ok;
+    case BotOp::Restart:
+        AddEvents(m_commands.Restart());
+        return CommandStatus::Ok;
+    }
+    return CommandStatus::Ok;
+}
+
+CommandStatus BotProtocol::FlyArrow(const BotRequest& request, BotResponse& response)
+{
+    if (request.m_numRooms > BotRequest::MaxRooms)
+        return CommandStatus::ArrowPathLength;
+
+    // The arrow stops flying once something happens: a hit, or a miss at the end of its
+    // path.
+    for (int i = 0; i < request.m_numRooms && m_events.Empty(); ++i)
+    {
+        CommandStatus status = m_commands.TryMoveArrow(request.m_rooms[i], m_events);
+        if (status != CommandStatus::Ok)
+            return status;
+        response.m_arrowRoomsFlown++;
+    }
+    return CommandStatus::Ok;
+}
+
+void BotProtocol::AddEvents(const eventvec& events)
+{
+    for (Event event : events)
+        m_events.Add(event);
+}
+
+void BotProtocol::Describe(CommandStatus status, BotResponse& response) const
+{
+    response.m_status = static_cast<uint8_t>(status);
+
+    if (m_playerState.PlayerAlive())
+        response.m_percepts |= BotResponse::PlayerAlive;
+    if (m_playerState.WumpusAlive())
+        response.m_percepts |= BotResponse::WumpusAlive;
+    if (m_playerState.WumpusAdjacent())
+        response.m_percepts |= BotResponse::WumpusAdjacent;
+    if (m_playerState.BatsAdjacent())
+        response.m_percepts |= BotResponse::BatsAdjacent;
+    if (m_playerState.PitAdjacent())
+        response.m_percepts |= BotResponse::PitAdjacent;
+
+    response.m_playerRoom = static_cast<uint8_t>(m_playerState.GetPlayerRoom());
+    response.m_arrowsRemaining = static_cast<uint8_t>(m_playerState.GetArrowsRemaining());
+    ints3 connected = m_playerState.GetPlayerConnectedRooms();
+    for (int i = 0; i < 3; ++i)
+        response.m_connectedRooms[i] = static_cast<uint8_t>(connected[i]);
+
+    response.m_numEvents = static_cast<uint8_t>(m_events.Size());
+    response.m_eventsDropped = static_cast<uint8_t>(min(m_events.Dropped(), 255));
+    for (int i = 0; i < m_events.Size(); ++i)
+        response.m_events[i] = static_cast<uint8_t>(m_events[i]);
+}
+
+void BotProtocol::Receive(string_view data, string& output)
+{
+    auto respond = [this, &output](const char* frame) {
+        BotRequest request;
+        memcpy(&request, frame, sizeof(request));
+        BotResponse response = Handle(request);
+        output.append(reinterpret_cast<const char*>(&response), sizeof(response));
+    };
+
+    if (!m_partialFrame.empty())
+    {
+        size_t needed = min(sizeof(BotRequest) - m_partialFrame.size(), data.size());
+        m_partialFrame.append(data.data(), needed);
+        data.remove_prefix(needed);
+        if (m_partialFrame.size() < sizeof(BotRequest))
+            return;
+        respond(m_partialFrame.data());
+        m_partialFrame.clear();
+    }
+
+    while (data.size() >= sizeof(BotRequest))
+    {
+        respond(data.data());
+        data.remove_prefix(sizeof(BotRequest));
+    }
+    m_partialFrame.assign(data.data(), data.size());
+}
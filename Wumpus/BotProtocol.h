@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include "Commands.h"
+#include "CommandStatus.h"
+#include "EventSink.h"
+#include "Map.h"
+#include "PlayerState.h"
+#include "stdtypes.h"
+
+// Binary alternative to Interpreter for programs playing the game: fixed-size request
+// frames carry whole commands, including a full arrow path, and each response frame gives
+// the command's status, its events as Event codes and what the player now perceives as
+// bits, so clients never parse message text. Every field is one byte, so there is no
+// byte order or padding to agree on, and room numbers must be below 256.
+enum class BotOp : uint8_t
+{
+    Start,      // Random placements for a new game
+    Move,       // Move to m_rooms[0]
+    Shoot,      // Prepare an arrow and fly it through the first m_numRooms rooms
+    MoveArrow,  // Fly an arrow left in flight by a rejected Shoot through more rooms
+    Replay,
+    Restart
+};
+
+class BotRequest
+{
+public:
+    static const int MaxRooms = 5;
+
+    BotOp m_op;
+    uint8_t m_numRooms;
+    uint8_t m_rooms[MaxRooms];
+    uint8_t m_reserved;
+};
+
+class BotResponse
+{
+public:
+    static const int MaxEvents = EventBuffer::Capacity;
+
+    // Percept bits.
+    static const uint8_t PlayerAlive = 1;
+    static const uint8_t WumpusAlive = 2;
+    static const uint8_t WumpusAdjacent = 4;
+    static const uint8_t BatsAdjacent = 8;
+    static const uint8_t PitAdjacent = 16;
+
+    // A CommandStatus, BadRequest, or NotStarted for a command before the first Start or
+    // Restart. A NotStarted response has every other field zero.
+    static const uint8_t BadRequest = 0xff;
+    static const uint8_t NotStarted = 0xfe;
+    uint8_t m_status;
+
+    uint8_t m_percepts;
+    uint8_t m_playerRoom;
+    uint8_t m_arrowsRemaining;
+    uint8_t m_connectedRooms[3];
+    uint8_t m_numEvents;
+    uint8_t m_events[MaxEvents];
+
+    // For Shoot and MoveArrow, how many of the request's rooms the arrow flew through. If
+    // a room is rejected the arrow stops short of it, still in flight.
+    uint8_t m_arrowRoomsFlown;
+
+    // Events lost because more than MaxEvents happened (only a long chain of bat snatches
+    // does that), capped at 255. When nonzero, the last event listed is still the last
+    // that happened.
+    uint8_t m_eventsDropped;
+    uint8_t m_reserved[6];
+};
+
+static_assert(sizeof(BotRequest) == 8, "BotRequest is a fixed-size frame");
+static_assert(sizeof(BotResponse) == 32, "BotResponse is a fixed-size frame");
+
+class BotProtocol
+{
+public:
+    // Room numbers are sent in one byte.
+    static const int MaxNumRooms = 255;
+
+    // The map must be the one being played on. Throws TooManyRoomsException if it has
+    // more than MaxNumRooms rooms.
+    BotProtocol(Commands& commands, const PlayerState& playerState, const Map& map);
+
+    BotResponse Handle(const BotRequest& request);
+
+    // Handles each whole request frame in data, appending its response frame to output.
+    // A frame may be split across calls.
+    void Receive(string_view data, string& output);
+
+private:
+    CommandStatus Execute(const BotRequest& request, BotResponse& response);
+    CommandStatus FlyArrow(const BotRequest& request, BotResponse& response);
+    void AddEvents(const eventvec& events);
+    void Describe(CommandStatus status, BotResponse& response) const;
+
+private:
+    Commands& m_commands;
+    const PlayerState& m_playerState;
+    EventBuffer m_events;
+    string m_partialFrame;
+};
@@ -0,0 +1,171 @@
+#include "catch.hpp"
+
+#include "BotProtocol.h"
+#include <cstring>
+#include "Exceptions.h"
+#include "Model.h"
+#include "RandomSourceStub.h"
+
+namespace {
+    BotRequest Request(BotOp op, intvec rooms = {})
+    {
+        BotRequest request = {};
+        request.m_op = op;
+        request.m_numRooms = static_cast<uint8_t>(rooms.size());
+        for (size_t i = 0; i < rooms.size() && i < BotRequest::MaxRooms; ++i)
+            request.m_rooms[i] = static_cast<uint8_t>(rooms[i]);
+        return request;
+    }
+
+    eventvec Events(const BotResponse& response)
+    {
+        eventvec events;
+        for (int i = 0; i < response.m_numEvents; ++i)
+            events.push_back(static_cast<Event>(response.m_events[i]));
+        return events;
+    }
+}
+
+TEST_CASE("BotProtocol")
+{
+    RandomSourceStub randomSource;
+    Model model(randomSource);
+    BotProtocol protocol(model, model, Map::Classic());
+
+    randomSource.SetNextInts({ 1, 3, 19, 20, 17, 18 });
+    BotResponse start = protocol.Handle(Request(BotOp::Start));
+
+    SECTION("Start")
+    {
+        REQUIRE(start.m_status == static_cast<uint8_t>(CommandStatus::Ok));
+        REQUIRE(start.m_percepts == (BotResponse::PlayerAlive | BotResponse::WumpusAlive));
+        REQUIRE(start.m_playerRoom == 1);
+        REQUIRE(start.m_arrowsRemaining == Model::MaxArrows);
+        REQUIRE(start.m_connectedRooms[0] == 2);
+        REQUIRE(start.m_connectedRooms[1] == 5);
+        REQUIRE(start.m_connectedRooms[2] == 8);
+        REQUIRE(start.m_numEvents == 0);
+    }
+
+    SECTION("Move")
+    {
+        BotResponse response = protocol.Handle(Request(BotOp::Move, { 2 }));
+        REQUIRE(response.m_status == static_cast<uint8_t>(CommandStatus::Ok));
+        REQUIRE(response.m_playerRoom == 2);
+        REQUIRE((response.m_percepts & BotResponse::WumpusAdjacent) != 0);
+    }
+
+    SECTION("Long bat snatch chain reports dropped events")
+    {
+        REQUIRE(start.m_eventsDropped == 0);
+        model.SetBatRooms(2, 19);
+        intvec drops(BotResponse::MaxEvents + 4, 19);
+        drops.push_back(8);
+        randomSource.SetNextInts(drops);
+
+        BotResponse response = protocol.Handle(Request(BotOp::Move, { 2 }));
+        REQUIRE(response.m_playerRoom == 8);
+        REQUIRE(response.m_numEvents == BotResponse::MaxEvents);
+        REQUIRE(response.m_eventsDropped == 5);
+    }
+
+    SECTION("Move to unconnected room")
+    {
+        BotResponse response = protocol.Handle(Request(BotOp::Move, { 3 }));
+        REQUIRE(response.m_status == static_cast<uint8_t>(CommandStatus::RoomsNotConnected));
+        REQUIRE(response.m_playerRoom == 1);
+    }
+
+    SECTION("Shoot the wumpus")
+    {
+        BotResponse response = protocol.Handle(Request(BotOp::Shoot, { 2, 3, 4 }));
+        REQUIRE(response.m_status == static_cast<uint8_t>(CommandStatus::Ok));
+        REQUIRE(Events(response) == eventvec({ Event::KilledWumpus }));
+        REQUIRE(response.m_arrowRoomsFlown == 2);
+        REQUIRE((response.m_percepts & BotResponse::WumpusAlive) == 0);
+    }
+
+    SECTION("Shoot with a bad path, then finish the flight")
+    {
+        BotResponse response = protocol.Handle(Request(BotOp::Shoot, { 2, 4, 5 }));
+        REQUIRE(response.m_status == static_cast<uint8_t>(CommandStatus::RoomsNotConnected));
+        REQUIRE(response.m_arrowRoomsFlown == 1);
+        REQUIRE(response.m_arrowsRemaining == Model::MaxArrows - 1);
+
+        randomSource.SetNextInts({ 3 });
+        response = protocol.Handle(Request(BotOp::MoveArrow, { 10, 11 }));
+        REQUIRE(response.m_status == static_cast<uint8_t>(CommandStatus::Ok));
+        REQUIRE(response.m_arrowRoomsFlown == 2);
+        REQUIRE(Events(response) == eventvec({ Event::MissedWumpus }));
+    }
+
+    SECTION("Path too long")
+    {
+        BotResponse response = protocol.Handle(Request(BotOp::Shoot, { 2, 3, 4, 5, 1, 2 }));
+        REQUIRE(response.m_status == static_cast<uint8_t>(CommandStatus::ArrowPathLength));
+    }
+
+    SECTION("Bad request")
+    {
+        BotRequest request = Request(BotOp::Start);
+        request.m_op = static_cast<BotOp>(42);
+        REQUIRE(protocol.Handle(request).m_status == BotResponse::BadRequest);
+    }
+
+    SECTION("Frames split across reads")
+    {
+        BotRequest requests[2] = { Request(BotOp::Move, { 2 }), Request(BotOp::Move, { 3 }) };
+        const char* bytes = reinterpret_cast<const char*>(requests);
+
+        string output;
+        protocol.Receive(string_view(bytes, 5), output);
+        REQUIRE(output.empty());
+        protocol.Receive(string_view(bytes + 5, 10), output);
+        REQUIRE(output.size() == sizeof(BotResponse));
+        protocol.Receive(string_view(bytes + 15, 1), output);
+        REQUIRE(output.size() == 2 * sizeof(BotResponse));
+
+        BotResponse response;
+        memcpy(&response, output.data() + sizeof(BotResponse), sizeof(response));
+        REQUIRE(response.m_playerRoom == 3);
+    }
+}
+
+TEST_CASE("BotProtocol before Start")
+{
+    RandomSourceStub randomSource;
+    Model model(randomSource);
+    BotProtocol protocol(model, model, Map::Classic());
+
+    SECTION("Commands are rejected")
+    {
+        BotResponse expected = {};
+        expected.m_status = BotResponse::NotStarted;
+        for (BotOp op : { BotOp::Move, BotOp::Shoot, BotOp::MoveArrow, BotOp::Replay })
+        {
+            BotResponse response = protocol.Handle(Request(op, { 2 }));
+            REQUIRE(memcmp(&response, &expected, sizeof(BotResponse)) == 0);
+        }
+    }
+
+    SECTION("Restart starts a game")
+    {
+        randomSource.SetNextInts({ 1, 3, 19, 20, 17, 18 });
+        BotResponse response = protocol.Handle(Request(BotOp::Restart));
+        REQUIRE(response.m_status == static_cast<uint8_t>(CommandStatus::Ok));
+        REQUIRE(response.m_playerRoom == 1);
+        REQUIRE(response.m_connectedRooms[0] == 2);
+    }
+}
+
+TEST_CASE("BotProtocol map size")
+{
+    const int numRooms = BotProtocol::MaxNumRooms + 1;
+    vector<ints2> tunnels;
+    for (int room = 1; room <= numRooms; ++room)
+        tunnels.push_back({ room, room % numRooms + 1 });
+    Map map(numRooms, tunnels);
+    RandomSourceStub randomSource;
+    Model model(randomSource, map);
+    REQUIRE_THROWS_AS(BotProtocol(model, model, map), TooManyRoomsException);
+}
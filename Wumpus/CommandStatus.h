@@ -0,0 +1,19 @@
+#pragma once
+
+// Result of a command that can reject its input. Each failure but Failed corresponds to
+// one of the exceptions in Exceptions.h.
+enum class CommandStatus
+{
+    Ok,
+    ArrowAlreadyPrepared,
+    ArrowDoubleBack,
+    ArrowPathLength,
+    NoSuchRoom,
+    OutOfArrows,
+    PlayerDead,
+    RoomsNotConnected,
+    // Any other GameException, which has no status of its own.
+    Failed
+};
+
+void ThrowIfFailed(CommandStatus status);
@@ -0,0 +1,110 @@
+#include "Commands.h"
+
+#include "Exceptions.h"
+
+void ThrowIfFailed(CommandStatus status)
+{
+    switch (status)
+    {
+    case CommandStatus::Ok:
+        return;
+    case CommandStatus::ArrowAlreadyPrepared:
+        throw ArrowAlreadyPreparedException();
+    case CommandStatus::ArrowDoubleBack:
+        throw ArrowDoubleBackException();
+    case CommandStatus::ArrowPathLength:
+        throw ArrowPathLengthException();
+    case CommandStatus::NoSuchRoom:
+        throw NoSuchRoomException();
+    case CommandStatus::OutOfArrows:
+        throw OutOfArrowsException();
+    case CommandStatus::PlayerDead:
+        throw PlayerDeadException();
+    case CommandStatus::RoomsNotConnected:
+        throw RoomsNotConnectedException();
+    case CommandStatus::Failed:
+        throw GameException();
+    }
+}
+
+CommandStatus Commands::TryMovePlayer(int room, EventSink& events) noexcept
+{
+    try
+    {
+        for (Event event : MovePlayer(room))
+            events.Add(event);
+        return CommandStatus::Ok;
+    }
+    catch (const GameException&)
+    {
+        return CaughtStatus();
+    }
+}
+
+CommandStatus Commands::TryPrepareArrow(int pathLength) noexcept
+{
+    try
+    {
+        PrepareArrow(pathLength);
+        return CommandStatus::Ok;
+    }
+    catch (const GameException&)
+    {
+        return CaughtStatus();
+    }
+}
+
+CommandStatus Commands::TryMoveArrow(int room, EventSink& events) noexcept
+{
+    try
+    {
+        for (Event event : MoveArrow(room))
+            events.Add(event);
+        return CommandStatus::Ok;
+    }
+    catch (const GameException&)
+    {
+        return CaughtStatus();
+    }
+}
+
+// Maps the GameException currently being handled to its status.
+CommandStatus Commands::CaughtStatus()
+{
+    try
+    {
+        throw;
+    }
+    catch (const ArrowAlreadyPreparedException&)
+    {
+        return CommandStatus::ArrowAlreadyPrepared;
+    }
+    catch (const ArrowDoubleBackException&)
+    {
+        return CommandStatus::ArrowDoubleBack;
+    }
+    catch (const ArrowPathLengthException&)
+    {
+        return CommandStatus::ArrowPathLength;
+    }
+    catch (const NoSuchRoomException&)
+    {
+        return CommandStatus::NoSuchRoom;
+    }
+    catch (const OutOfArrowsException&)
+    {
+        return CommandStatus::OutOfArrows;
+    }
+    catch (const PlayerDeadException&)
+    {
+        return CommandStatus::PlayerDead;
+    }
+    catch (const RoomsNotConnectedException&)
+    {
+        return CommandStatus::RoomsNotConnected;
+    }
+    catch (const GameException&)
+    {
+        return CommandStatus::Failed;
+    }
+}
@@ -1,8 +1,8 @@
 #pragma once
 
+#include "CommandStatus.h"
 #include "Event.h"
-
-using eventvec = vector<Event>;
+#include "EventSink.h"
 
 class Commands
 {
@@ -13,4 +13,14 @@ public:
     virtual eventvec MoveArrow(int room) = 0;
     virtual eventvec Replay() = 0;
     virtual eventvec Restart() = 0;
+
+    // Non-throwing versions of MovePlayer, PrepareArrow and MoveArrow, reporting invalid
+    // input as a status instead. The defaults wrap the throwing versions; implementations
+    // on a hot path should override them.
+    virtual CommandStatus TryMovePlayer(int room, EventSink& events) noexcept;
+    virtual CommandStatus TryPrepareArrow(int pathLength) noexcept;
+    virtual CommandStatus TryMoveArrow(int room, EventSink& events) noexcept;
+
+private:
+    static CommandStatus CaughtStatus();
 };
@@ -12,3 +12,5 @@ enum class Event
     MissedWumpus,
     ShotSelf
 };
+
+using eventvec = vector<Event>;
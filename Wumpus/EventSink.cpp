@@ -0,0 +1,71 @@
+#include "EventSink.h"
+
+EventVecSink::EventVecSink(eventvec& events)
+    : m_events(events)
+{
+}
+
+void EventVecSink::Add(Event event)
+{
+    m_events.push_back(event);
+}
+
+const int EventBuffer::Capacity;
+
+EventBuffer::EventBuffer()
+    : m_size(0)
+    , m_dropped(0)
+{
+}
+
+void EventBuffer::Add(Event event)
+{
+    if (m_size < Capacity)
+        m_events[m_size++] = event;
+    else
+    {
+        m_events[Capacity - 1] = event;
+        m_dropped++;
+    }
+}
+
+void EventBuffer::Clear()
+{
+    m_size = 0;
+    m_dropped = 0;
+}
+
+bool EventBuffer::Empty() const
+{
+    return m_size == 0;
+}
+
+int EventBuffer::Size() const
+{
+    return m_size;
+}
+
+int EventBuffer::Dropped() const
+{
+    return m_dropped;
+}
+
+Event EventBuffer::operator[](int index) const
+{
+    return m_events[index];
+}
+
+Event EventBuffer::Back() const
+{
+    return m_events[m_size - 1];
+}
+
+const Event* EventBuffer::begin() const
+{
+    return m_events.data();
+}
+
+const Event* EventBuffer::end() const
+{
+    return m_events.data() + m_size;
+}
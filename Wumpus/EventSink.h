@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Event.h"
+
+// Receives the events a Model command produces, in order, without the command having to
+// build and return a container.
+class EventSink
+{
+public:
+    virtual void Add(Event event) = 0;
+};
+
+// Appends events to a caller-owned eventvec. Backs the eventvec-returning Commands API.
+class EventVecSink : public EventSink
+{
+public:
+    explicit EventVecSink(eventvec& events);
+
+    void Add(Event event) override;
+
+private:
+    eventvec& m_events;
+};
+
+// Fixed-capacity inline buffer that never allocates. A command only produces more than a
+// few events through an unlikely chain of bat snatches; if the buffer fills up, each
+// further event replaces the last one held, so the event that decided the outcome is
+// always the last one kept. Dropped() says how many were lost that way, so callers can
+// tell a complete list from a truncated one.
+class EventBuffer : public EventSink
+{
+public:
+    static const int Capacity = 16;
+
+    EventBuffer();
+
+    void Add(Event event) override;
+    void Clear();
+
+    bool Empty() const;
+    int Size() const;
+    int Dropped() const;
+    Event operator[](int index) const;
+    Event Back() const;
+    const Event* begin() const;
+    const Event* end() const;
+
+private:
+    array<Event, Capacity> m_events;
+    int m_size;
+    int m_dropped;
+};
@@ -0,0 +1,59 @@
+#include "catch.hpp"
+
+#include "EventSink.h"
+
+TEST_CASE("EventVecSink")
+{
+    eventvec events = { Event::BumpedWumpus };
+    EventVecSink sink(events);
+    sink.Add(Event::EatenByWumpus);
+    REQUIRE(events == eventvec({
+        Event::BumpedWumpus, Event::EatenByWumpus
+    }));
+}
+
+TEST_CASE("EventBuffer")
+{
+    EventBuffer events;
+
+    SECTION("Starts empty")
+    {
+        REQUIRE(events.Empty());
+        REQUIRE(events.Size() == 0);
+        REQUIRE(events.begin() == events.end());
+    }
+
+    SECTION("Keeps events in order")
+    {
+        events.Add(Event::BatSnatch);
+        events.Add(Event::FellInPit);
+        REQUIRE(events.Size() == 2);
+        REQUIRE(events.Dropped() == 0);
+        REQUIRE(events[0] == Event::BatSnatch);
+        REQUIRE(events.Back() == Event::FellInPit);
+        REQUIRE(eventvec(events.begin(), events.end()) == eventvec({
+            Event::BatSnatch, Event::FellInPit
+        }));
+    }
+
+    SECTION("Clear")
+    {
+        events.Add(Event::BatSnatch);
+        events.Clear();
+        REQUIRE(events.Empty());
+    }
+
+    SECTION("Overflow keeps the latest event last")
+    {
+        for (int i = 0; i < EventBuffer::Capacity + 3; ++i)
+            events.Add(Event::BatSnatch);
+        events.Add(Event::FellInPit);
+        REQUIRE(events.Size() == EventBuffer::Capacity);
+        REQUIRE(events[EventBuffer::Capacity - 2] == Event::BatSnatch);
+        REQUIRE(events.Back() == Event::FellInPit);
+        REQUIRE(events.Dropped() == 4);
+
+        events.Clear();
+        REQUIRE(events.Dropped() == 0);
+    }
+}
@@ -16,10 +16,22 @@ class ArrowPathLengthException : public GameException
 {
 };
 
+class MapFormatException : public GameException
+{
+};
+
+class NoDistanceTableException : public GameException
+{
+};
+
 class NoSuchRoomException : public GameException
 {
 };
 
+class NothingToUndoException : public GameException
+{
+};
+
 class OutOfArrowsException : public GameException
 {
 };
@@ -31,3 +43,15 @@ class PlayerDeadException : public GameException
 class RoomsNotConnectedException : public GameException
 {
 };
+
+class SnapshotException : public GameException
+{
+};
+
+class TooManyRoomsException : public GameException
+{
+};
+
+class TunnelCountException : public GameException
+{
+};
@@ -0,0 +1,54 @@
+#include "FileDescriptor.h"
+
+#ifdef __linux__
+
+#include <unistd.h>
+#include <utility>
+
+using namespace std;
+
+FileDescriptor::FileDescriptor()
+    : m_fd(-1)
+{
+}
+
+FileDescriptor::FileDescriptor(int fd)
+    : m_fd(fd)
+{
+}
+
+FileDescriptor::FileDescriptor(FileDescriptor&& other) noexcept
+    : m_fd(exchange(other.m_fd, -1))
+{
+}
+
+FileDescriptor& FileDescriptor::operator=(FileDescriptor&& other) noexcept
+{
+    if (this != &other)
+        Reset(exchange(other.m_fd, -1));
+    return *this;
+}
+
+FileDescriptor::~FileDescriptor()
+{
+    Reset();
+}
+
+int FileDescriptor::Get() const
+{
+    return m_fd;
+}
+
+bool FileDescriptor::IsValid() const
+{
+    return m_fd >= 0;
+}
+
+void FileDescriptor::Reset(int fd)
+{
+    if (m_fd >= 0)
+        close(m_fd);
+    m_fd = fd;
+}
+
+#endif
@@ -0,0 +1,27 @@
+#pragma once
+
+// Owns a file descriptor and closes it when destroyed, so a constructor that fails
+// partway through doesn't leak the descriptors it already opened. Linux only.
+class FileDescriptor
+{
+public:
+    // Holds no descriptor.
+    FileDescriptor();
+    // Takes ownership of fd, which may be negative for none.
+    explicit FileDescriptor(int fd);
+
+    FileDescriptor(FileDescriptor&& other) noexcept;
+    FileDescriptor& operator=(FileDescriptor&& other) noexcept;
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator=(const FileDescriptor&) = delete;
+    ~FileDescriptor();
+
+    int Get() const;
+    bool IsValid() const;
+
+    // Closes the descriptor held, if any, and takes ownership of fd instead.
+    void Reset(int fd = -1);
+
+private:
+    int m_fd;
+};
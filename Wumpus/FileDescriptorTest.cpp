@@ -0,0 +1,54 @@
+#include "catch.hpp"
+
+#ifdef __linux__
+
+#include <fcntl.h>
+#include "FileDescriptor.h"
+#include <unistd.h>
+#include <utility>
+
+namespace {
+    bool IsOpen(int fd)
+    {
+        return fcntl(fd, F_GETFD) != -1;
+    }
+}
+
+TEST_CASE("FileDescriptor")
+{
+    int fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    REQUIRE(fd >= 0);
+
+    SECTION("Closes when destroyed")
+    {
+        {
+            FileDescriptor owner(fd);
+            REQUIRE(owner.Get() == fd);
+            REQUIRE(owner.IsValid());
+        }
+        REQUIRE(!IsOpen(fd));
+    }
+
+    SECTION("Move transfers ownership")
+    {
+        FileDescriptor owner(fd);
+        FileDescriptor other(std::move(owner));
+        REQUIRE(!owner.IsValid());
+        REQUIRE(other.Get() == fd);
+
+        FileDescriptor assigned;
+        assigned = std::move(other);
+        REQUIRE(assigned.Get() == fd);
+        REQUIRE(IsOpen(fd));
+    }
+
+    SECTION("Reset closes the old descriptor")
+    {
+        FileDescriptor owner(fd);
+        owner.Reset();
+        REQUIRE(!owner.IsValid());
+        REQUIRE(!IsOpen(fd));
+    }
+}
+
+#endif
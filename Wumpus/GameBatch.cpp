@@ -0,0 +1,221 @@
+#include "GameBatch.h"
+
+#include "Model.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    int PaddedSize(int size)
+    {
+        return (size + GameBatch::LaneCount - 1) / GameBatch::LaneCount * GameBatch::LaneCount;
+    }
+}
+
+const int GameBatch::LaneCount;
+
+void GameBatch::ValidateRoom(int room) const
+{
+    if (!m_map.IsRoom(room))
+        throw NoSuchRoomException();
+}
+
+GameBatch::GameBatch(int size)
+    : m_size(size)
+    , m_playerRooms(PaddedSize(size), 0)
+    , m_wumpusRooms(PaddedSize(size), 0)
+    , m_batRooms1(PaddedSize(size), 0)
+    , m_batRooms2(PaddedSize(size), 0)
+    , m_pitRooms1(PaddedSize(size), 0)
+    , m_pitRooms2(PaddedSize(size), 0)
+    , m_arrowsRemaining(PaddedSize(size), Model::MaxArrows)
+    , m_playerAlive(PaddedSize(size), 0)
+{
+    fill(m_playerAlive.begin(), m_playerAlive.begin() + size, 1);
+}
+
+int GameBatch::GetSize() const
+{
+    return m_size;
+}
+
+void GameBatch::SetGame(int game, int playerRoom, int wumpusRoom, ints2 batRooms, ints2 pitRooms)
+{
+    ValidateRoom(playerRoom);
+    ValidateRoom(wumpusRoom);
+    ValidateRoom(batRooms[0]);
+    ValidateRoom(batRooms[1]);
+    ValidateRoom(pitRooms[0]);
+    ValidateRoom(pitRooms[1]);
+
+    m_playerRooms[game] = playerRoom;
+    m_wumpusRooms[game] = wumpusRoom;
+    m_batRooms1[game] = batRooms[0];
+    m_batRooms2[game] = batRooms[1];
+    m_pitRooms1[game] = pitRooms[0];
+    m_pitRooms2[game] = pitRooms[1];
+    m_arrowsRemaining[game] = Model::MaxArrows;
+    m_playerAlive[game] = 1;
+}
+
+void GameBatch::SetPlayerRoom(int game, int room)
+{
+    ValidateRoom(room);
+    m_playerRooms[game] = room;
+}
+
+void GameBatch::RandomPlacements(RandomSource& randomSource)
+{
+    // One batch for every game, in the same per-game order as Model::RandomPlacements.
+    intvec rooms(6 * m_size);
+    randomSource.NextInts(1, m_map.GetNumRooms(), rooms.data(), 6 * m_size);
+    for (int game = 0; game < m_size; ++game)
+    {
+        const int* gameRooms = &rooms[6 * game];
+        m_playerRooms[game] = gameRooms[0];
+        m_wumpusRooms[game] = gameRooms[1];
+        m_batRooms1[game] = gameRooms[2];
+        m_batRooms2[game] = gameRooms[3];
+        m_pitRooms1[game] = gameRooms[4];
+        m_pitRooms2[game] = gameRooms[5];
+        m_arrowsRemaining[game] = Model::MaxArrows;
+        m_playerAlive[game] = 1;
+    }
+    PlacePlayers(randomSource);
+}
+
+void GameBatch::PlacePlayers(RandomSource& randomSource)
+{
+    // Pits resolve without randomness, so CheckHazards settles them for a whole group at
+    // once. Bats and the wumpus need random draws; those rare games go through the scalar
+    // PlacePlayer, in game order so the draw sequence does not depend on the lane layout.
+    for (int first = 0; first < m_size; first += LaneCount)
+    {
+        unsigned needsDraws = CheckHazards(first);
+        for (int lane = 0; needsDraws != 0; ++lane, needsDraws >>= 1)
+        {
+            if (needsDraws & 1)
+                PlacePlayer(first + lane, randomSource);
+        }
+    }
+}
+
+#ifdef __AVX2__
+
+unsigned GameBatch::CheckHazards(int first)
+{
+    __m256i player = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&m_playerRooms[first]));
+    __m256i wumpus = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&m_wumpusRooms[first]));
+    __m256i bat1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&m_batRooms1[first]));
+    __m256i bat2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&m_batRooms2[first]));
+    __m256i pit1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&m_pitRooms1[first]));
+    __m256i pit2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&m_pitRooms2[first]));
+    __m256i alive = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&m_playerAlive[first]));
+
+    __m256i isAlive = _mm256_cmpgt_epi32(alive, _mm256_setzero_si256());
+    __m256i inWumpusRoom = _mm256_cmpeq_epi32(player, wumpus);
+    __m256i inBatRoom = _mm256_or_si256(_mm256_cmpeq_epi32(player, bat1), _mm256_cmpeq_epi32(player, bat2));
+    __m256i inPitRoom = _mm256_or_si256(_mm256_cmpeq_epi32(player, pit1), _mm256_cmpeq_epi32(player, pit2));
+
+    __m256i needsDraws = _mm256_and_si256(_mm256_or_si256(inWumpusRoom, inBatRoom), isAlive);
+    __m256i fellInPit = _mm256_andnot_si256(needsDraws, _mm256_and_si256(inPitRoom, isAlive));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(&m_playerAlive[first]), _mm256_andnot_si256(fellInPit, alive));
+
+    return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(needsDraws)));
+}
+
+#else
+
+unsigned GameBatch::CheckHazards(int first)
+{
+    unsigned needsDraws = 0;
+    for (int lane = 0; lane < LaneCount; ++lane)
+    {
+        int game = first + lane;
+        if (!m_playerAlive[game])
+            continue;
+
+        int room = m_playerRooms[game];
+        bool inWumpusRoom = (room == m_wumpusRooms[game]);
+        bool inBatRoom = (room == m_batRooms1[game] || room == m_batRooms2[game]);
+        bool inPitRoom = (room == m_pitRooms1[game] || room == m_pitRooms2[game]);
+
+        if (inWumpusRoom || inBatRoom)
+            needsDraws |= 1u << lane;
+        else if (inPitRoom)
+            m_playerAlive[game] = 0;
+    }
+    return needsDraws;
+}
+
+#endif
+
+void GameBatch::PlacePlayer(int game, RandomSource& randomSource)
+{
+    int room = m_playerRooms[game];
+    bool inWumpusRoom = (room == m_wumpusRooms[game]);
+    bool inBatRoom = (room == m_batRooms1[game] || room == m_batRooms2[game]);
+    bool inPitRoom = (room == m_pitRooms1[game] || room == m_pitRooms2[game]);
+
+    if (inBatRoom)
+    {
+        m_playerRooms[game] = randomSource.NextInt(1, m_map.GetNumRooms());
+        PlacePlayer(game, randomSource);
+        if (inWumpusRoom && m_playerAlive[game])
+            MoveWumpus(game, randomSource);
+    }
+    else if (inWumpusRoom)
+    {
+        MoveWumpus(game, randomSource);
+        if (inPitRoom)
+            m_playerAlive[game] = 0;
+    }
+    else if (inPitRoom)
+    {
+        m_playerAlive[game] = 0;
+    }
+}
+
+void GameBatch::MoveWumpus(int game, RandomSource& randomSource)
+{
+    // As in Model: each tunnel, or staying put, is equally likely.
+    RoomList tunnels = m_map.GetTunnels(m_wumpusRooms[game]);
+    int roomIndex = randomSource.NextInt(0, tunnels.size());
+    if (roomIndex < tunnels.size())
+        m_wumpusRooms[game] = tunnels[roomIndex];
+
+    if (m_wumpusRooms[game] == m_playerRooms[game])
+        m_playerAlive[game] = 0;
+}
+
+int GameBatch::GetPlayerRoom(int game) const
+{
+    return m_playerRooms[game];
+}
+
+int GameBatch::GetWumpusRoom(int game) const
+{
+    return m_wumpusRooms[game];
+}
+
+ints2 GameBatch::GetBatRooms(int game) const
+{
+    return { m_batRooms1[game], m_batRooms2[game] };
+}
+
+ints2 GameBatch::GetPitRooms(int game) const
+{
+    return { m_pitRooms1[game], m_pitRooms2[game] };
+}
+
+int GameBatch::GetArrowsRemaining(int game) const
+{
+    return m_arrowsRemaining[game];
+}
+
+bool GameBatch::PlayerAlive(int game) const
+{
+    return m_playerAlive[game] != 0;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Map.h"
+#include "RandomSource.h"
+#include "stdtypes.h"
+
+// State for many independent games laid out as one array per field, so that the
+// hazard checks in PlacePlayers can test a group of games at once with AVX2. Room
+// placement follows the same rules as Model::PlacePlayer, but no events are reported;
+// callers read the resulting rooms and alive flags instead. Games are played on
+// Map::Classic().
+class GameBatch
+{
+public:
+    // Games handled per AVX2 step: eight 32-bit lanes.
+    static const int LaneCount = 8;
+
+    explicit GameBatch(int size);
+
+    int GetSize() const;
+
+    void SetGame(int game, int playerRoom, int wumpusRoom, ints2 batRooms, ints2 pitRooms);
+    void SetPlayerRoom(int game, int room);
+    void RandomPlacements(RandomSource& randomSource);
+    void PlacePlayers(RandomSource& randomSource);
+
+    int GetPlayerRoom(int game) const;
+    int GetWumpusRoom(int game) const;
+    ints2 GetBatRooms(int game) const;
+    ints2 GetPitRooms(int game) const;
+    int GetArrowsRemaining(int game) const;
+    bool PlayerAlive(int game) const;
+
+private:
+    void ValidateRoom(int room) const;
+    unsigned CheckHazards(int firstGame);
+    void PlacePlayer(int game, RandomSource& randomSource);
+    void MoveWumpus(int game, RandomSource& randomSource);
+
+private:
+    const Map& m_map = Map::Classic();
+    int m_size;
+
+    // Each array is padded to a whole number of lanes.
+    intvec m_playerRooms;
+    intvec m_wumpusRooms;
+    intvec m_batRooms1;
+    intvec m_batRooms2;
+    intvec m_pitRooms1;
+    intvec m_pitRooms2;
+    intvec m_arrowsRemaining;
+    intvec m_playerAlive;
+};
@@ -0,0 +1,155 @@
+#include "catch.hpp"
+
+#include "GameBatch.h"
+#include "Model.h"
+#include "RandomSourceStub.h"
+#include "SimpleRandomSource.h"
+
+namespace
+{
+    // Returns the given ints first, then draws from another source.
+    class PrefixedRandomSource : public RandomSource
+    {
+    public:
+        PrefixedRandomSource(const intvec& prefix, RandomSource& rest)
+            : m_prefix(prefix)
+            , m_rest(rest)
+        {
+        }
+
+        int NextInt(int from, int to) override
+        {
+            return (m_next < m_prefix.size()) ? m_prefix[m_next++] : m_rest.NextInt(from, to);
+        }
+
+        unique_ptr<RandomSource> Clone() const override
+        {
+            return make_unique<PrefixedRandomSource>(*this);
+        }
+
+    private:
+        intvec m_prefix;
+        size_t m_next = 0;
+        RandomSource& m_rest;
+    };
+}
+
+TEST_CASE("GameBatch")
+{
+    RandomSourceStub randomSource;
+    GameBatch batch(11);
+
+    SECTION("Padded lanes are not reported")
+    {
+        REQUIRE(batch.GetSize() == 11);
+    }
+
+    SECTION("Set game")
+    {
+        batch.SetGame(10, 2, 11, { 5, 16 }, { 7, 9 });
+        REQUIRE(batch.GetPlayerRoom(10) == 2);
+        REQUIRE(batch.GetWumpusRoom(10) == 11);
+        REQUIRE(batch.GetBatRooms(10) == ints2({ 5, 16 }));
+        REQUIRE(batch.GetPitRooms(10) == ints2({ 7, 9 }));
+        REQUIRE(batch.GetArrowsRemaining(10) == Model::MaxArrows);
+        REQUIRE(batch.PlayerAlive(10));
+    }
+
+    SECTION("Set game to non-existent room")
+    {
+        REQUIRE_THROWS_AS(batch.SetGame(0, 0, 11, { 5, 16 }, { 7, 9 }), NoSuchRoomException);
+        REQUIRE_THROWS_AS(batch.SetPlayerRoom(0, 21), NoSuchRoomException);
+    }
+
+    SECTION("Place players")
+    {
+        for (int game = 0; game < batch.GetSize(); ++game)
+            batch.SetGame(game, 2, 11, { 5, 16 }, { 7, 9 });
+
+        SECTION("No hazards")
+        {
+            batch.PlacePlayers(randomSource);
+            for (int game = 0; game < batch.GetSize(); ++game)
+            {
+                REQUIRE(batch.PlayerAlive(game));
+                REQUIRE(batch.GetPlayerRoom(game) == 2);
+            }
+        }
+
+        SECTION("Fall in pit")
+        {
+            batch.SetPlayerRoom(3, 7);
+            batch.SetPlayerRoom(9, 9);
+            batch.PlacePlayers(randomSource);
+            REQUIRE(!batch.PlayerAlive(3));
+            REQUIRE(!batch.PlayerAlive(9));
+            REQUIRE(batch.PlayerAlive(4));
+        }
+
+        SECTION("Bat snatch")
+        {
+            batch.SetPlayerRoom(1, 5);
+            batch.SetPlayerRoom(8, 16);
+            randomSource.SetNextInts({ 3, 7 });
+            batch.PlacePlayers(randomSource);
+            REQUIRE(batch.PlayerAlive(1));
+            REQUIRE(batch.GetPlayerRoom(1) == 3);
+            REQUIRE(!batch.PlayerAlive(8));
+            REQUIRE(batch.GetPlayerRoom(8) == 7);
+        }
+
+        SECTION("Bumped wumpus")
+        {
+            batch.SetPlayerRoom(0, 11);
+            batch.SetPlayerRoom(10, 11);
+            randomSource.SetNextInts({ 0, 3 });
+            batch.PlacePlayers(randomSource);
+            REQUIRE(batch.PlayerAlive(0));
+            REQUIRE(batch.GetWumpusRoom(0) == 10);
+            REQUIRE(!batch.PlayerAlive(10));
+            REQUIRE(batch.GetWumpusRoom(10) == 11);
+        }
+
+        SECTION("Dead players stay put")
+        {
+            batch.SetPlayerRoom(2, 7);
+            batch.PlacePlayers(randomSource);
+            batch.SetPlayerRoom(2, 5);
+            batch.PlacePlayers(randomSource);
+            REQUIRE(!batch.PlayerAlive(2));
+            REQUIRE(batch.GetPlayerRoom(2) == 5);
+        }
+    }
+}
+
+TEST_CASE("GameBatch matches Model")
+{
+    // Not a multiple of LaneCount, so the last group has padding lanes.
+    const int size = 11;
+    for (unsigned seed = 0; seed < 1000; ++seed)
+    {
+        INFO("Seed " << seed);
+        SimpleRandomSource batchRandomSource(seed);
+        GameBatch batch(size);
+        batch.RandomPlacements(batchRandomSource);
+
+        // The batch draws every game's placements up front, then the draws for bats and
+        // the wumpus game by game; feed each Model the same numbers.
+        SimpleRandomSource modelRandomSource(seed);
+        intvec rooms(6 * size);
+        for (int& room : rooms)
+            room = modelRandomSource.NextInt(1, 20);
+
+        for (int game = 0; game < size; ++game)
+        {
+            INFO("Game " << game);
+            PrefixedRandomSource gameRandomSource(intvec(&rooms[6 * game], &rooms[6 * game] + 6), modelRandomSource);
+            Model model(gameRandomSource);
+            model.RandomPlacements();
+
+            REQUIRE(batch.PlayerAlive(game) == model.PlayerAlive());
+            REQUIRE(batch.GetPlayerRoom(game) == model.GetPlayerRoom());
+            REQUIRE(batch.GetWumpusRoom(game) == model.GetWumpusRoom());
+        }
+    }
+}
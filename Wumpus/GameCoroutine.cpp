@@ -0,0 +1,219 @@
+#include "GameCoroutine.h"
+
+#include "EventSink.h"
+#include "Interpreter.h"
+#include "ParseInt.h"
+#include <utility>
+
+bool GameCoroutine::GetIo::await_suspend(coroutine_handle<promise_type> handle) noexcept
+{
+    m_io = &handle.promise().m_io;
+    return false;
+}
+
+GameCoroutine GameCoroutine::promise_type::get_return_object()
+{
+    return GameCoroutine(coroutine_handle<promise_type>::from_promise(*this));
+}
+
+GameCoroutine::NextInput GameCoroutine::promise_type::yield_value(MsgId prompt)
+{
+    m_io.m_output.push_back(prompt);
+    return NextInput{ &m_io };
+}
+
+void GameCoroutine::promise_type::unhandled_exception()
+{
+    m_exception = current_exception();
+}
+
+GameCoroutine::GameCoroutine(coroutine_handle<promise_type> handle)
+    : m_handle(handle)
+{
+}
+
+GameCoroutine::GameCoroutine(GameCoroutine&& other) noexcept
+    : m_handle(exchange(other.m_handle, nullptr))
+{
+}
+
+GameCoroutine& GameCoroutine::operator=(GameCoroutine&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (m_handle)
+            m_handle.destroy();
+        m_handle = exchange(other.m_handle, nullptr);
+    }
+    return *this;
+}
+
+GameCoroutine::~GameCoroutine()
+{
+    if (m_handle)
+        m_handle.destroy();
+}
+
+const tokenvec& GameCoroutine::InputTokens(string_view input)
+{
+    promise_type& promise = m_handle.promise();
+    promise.m_io.m_output.clear();
+    if (m_handle.done())
+        return promise.m_io.m_output;
+
+    promise.m_io.m_input = input;
+    m_handle.resume();
+    if (promise.m_exception)
+        rethrow_exception(exchange(promise.m_exception, nullptr));
+    return promise.m_io.m_output;
+}
+
+bool GameCoroutine::IsOver() const
+{
+    return m_handle.done();
+}
+
+namespace
+{
+    void OutputPlayerState(const PlayerState& playerState, const RoomText* roomText, tokenvec& output)
+    {
+        if (playerState.WumpusAdjacent())
+            output.push_back(MsgId::SmellWumpus);
+        if (playerState.BatsAdjacent())
+            output.push_back(MsgId::BatsNearby);
+        if (playerState.PitAdjacent())
+            output.push_back(MsgId::FeelDraft);
+
+        int room = playerState.GetPlayerRoom();
+        ints3 connected = playerState.GetPlayerConnectedRooms();
+        if (roomText != nullptr)
+        {
+            output.push_back(MsgToken(MsgId::YouAreInRoom, room, roomText->GetLocation(room)));
+            output.push_back(MsgToken(MsgId::TunnelsLeadTo, connected, roomText->GetTunnels(room)));
+        }
+        else
+        {
+            output.push_back(MsgToken(MsgId::YouAreInRoom, room));
+            output.push_back(MsgToken(MsgId::TunnelsLeadTo, connected));
+        }
+        output.push_back(MsgId::Blank);
+    }
+}
+
+GameCoroutine PlayGame(Commands& commands, const PlayerState& playerState, const RoomText* roomText)
+{
+    GameCoroutine::Io& io = co_await GameCoroutine::GetIo();
+    tokenvec& output = io.m_output;
+    eventvec events;
+    EventVecSink eventSink(events);
+
+    output.push_back(MsgId::HuntTheWumpus);
+    if (io.m_input == Interpreter::Randomize)
+        events = commands.RandomPlacements();
+
+    for (;;)
+    {
+        // Report what the last command (or the placements) led to.
+        output.push_back(MsgId::Blank);
+        for (Event event : events)
+            output.push_back(EventMsg(event));
+        events.clear();
+
+        if (!playerState.WumpusAlive())
+        {
+            output.push_back(MsgId::GetYouNextTime);
+            co_return;
+        }
+
+        if (playerState.PlayerAlive() && playerState.GetArrowsRemaining() > 0)
+        {
+            OutputPlayerState(playerState, roomText, output);
+
+            string_view command;
+            for (;;)
+            {
+                command = co_yield MsgId::ShootOrMove;
+                if (command == "M" || command == "m" || command == "S" || command == "s")
+                    break;
+                if (!command.empty())
+                    output.push_back(MsgId::Huh);
+            }
+
+            if (command == "M" || command == "m")
+            {
+                for (;;)
+                {
+                    string_view input = co_yield MsgId::WhereTo;
+                    int room;
+                    if (input.empty())
+                        continue;
+                    if (!ParseInt(input, room))
+                        output.push_back(MsgId::Huh);
+                    else if (commands.TryMovePlayer(room, eventSink) != CommandStatus::Ok)
+                        output.push_back(MsgId::Impossible);
+                    else
+                        break;
+                }
+                continue;
+            }
+
+            for (;;)
+            {
+                string_view input = co_yield MsgId::NumberOfRooms;
+                int pathLength;
+                if (input.empty())
+                    continue;
+                if (!ParseInt(input, pathLength))
+                    output.push_back(MsgId::Huh);
+                else if (commands.TryPrepareArrow(pathLength) != CommandStatus::Ok)
+                    output.push_back(MsgId::Impossible);
+                else
+                    break;
+            }
+
+            // The arrow flies on until it hits something or runs out of rooms, which is
+            // when there are events to report.
+            while (events.empty())
+            {
+                string_view input = co_yield MsgId::RoomNumber;
+                int room;
+                if (input.empty())
+                    continue;
+                if (!ParseInt(input, room))
+                {
+                    output.push_back(MsgId::Huh);
+                    continue;
+                }
+
+                CommandStatus status = commands.TryMoveArrow(room, eventSink);
+                if (status == CommandStatus::ArrowDoubleBack)
+                    output.push_back(MsgId::NotThatCrooked);
+                else if (status != CommandStatus::Ok)
+                    output.push_back(MsgId::Impossible);
+            }
+            continue;
+        }
+
+        if (playerState.PlayerAlive())
+            output.push_back(MsgId::OutOfArrows);
+        output.push_back(MsgId::YouLose);
+
+        for (;;)
+        {
+            string_view input = co_yield MsgId::SameSetup;
+            if (input == "Y" || input == "y")
+            {
+                events = commands.Replay();
+                break;
+            }
+            if (input == "N" || input == "n")
+            {
+                events = commands.Restart();
+                break;
+            }
+            if (!input.empty())
+                output.push_back(MsgId::Huh);
+        }
+        output.push_back(MsgId::HuntTheWumpus);
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <string_view>
+#include "Commands.h"
+#include "MsgToken.h"
+#include "PlayerState.h"
+#include "RoomText.h"
+#include "stdtypes.h"
+
+// A game session as a C++20 coroutine, an alternative to Interpreter for driving games
+// from an async I/O loop. The flow of the game is ordinary code (see PlayGame) that
+// co_yields each prompt and resumes with the next line of input, rather than a set of
+// explicit states. Between lines a session is only its suspended coroutine frame, with
+// no thread or stack of its own.
+//
+// Takes the same input and gives the same output as Interpreter::InputTokens, including
+// Interpreter::Randomize as the first line.
+class GameCoroutine
+{
+public:
+    class promise_type;
+
+    // What the game's body reads input from and writes output to.
+    class Io
+    {
+    public:
+        string_view m_input;
+        tokenvec m_output;
+    };
+
+    // co_await GetIo() gives the body its Io without suspending.
+    class GetIo
+    {
+    public:
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(coroutine_handle<promise_type> handle) noexcept;
+        Io& await_resume() const noexcept { return *m_io; }
+
+    private:
+        Io* m_io = nullptr;
+    };
+
+    // The result of co_yield: outputs the prompt and suspends, then gives the next line.
+    class NextInput
+    {
+    public:
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(coroutine_handle<>) const noexcept {}
+        string_view await_resume() const noexcept { return m_io->m_input; }
+
+        Io* m_io;
+    };
+
+    class promise_type
+    {
+    public:
+        GameCoroutine get_return_object();
+        suspend_always initial_suspend() noexcept { return {}; }
+        suspend_always final_suspend() noexcept { return {}; }
+        NextInput yield_value(MsgId prompt);
+        void return_void() {}
+        void unhandled_exception();
+
+        Io m_io;
+        exception_ptr m_exception;
+    };
+
+    GameCoroutine(GameCoroutine&& other) noexcept;
+    GameCoroutine& operator=(GameCoroutine&& other) noexcept;
+    ~GameCoroutine();
+
+    // Resumes the game with a line of input. Returns the output produced before it next
+    // needs input, in a buffer that is reused by the next call.
+    const tokenvec& InputTokens(string_view input);
+
+    bool IsOver() const;
+
+private:
+    explicit GameCoroutine(coroutine_handle<promise_type> handle);
+
+private:
+    coroutine_handle<promise_type> m_handle;
+};
+
+// Starts a session. If given, roomText must describe the same Map as playerState.
+GameCoroutine PlayGame(Commands& commands, const PlayerState& playerState, const RoomText* roomText = nullptr);
@@ -0,0 +1,82 @@
+#include "catch.hpp"
+
+#include "GameCoroutine.h"
+#include "Interpreter.h"
+#include "Model.h"
+#include "XoshiroRandomSource.h"
+
+namespace {
+    const char* const Inputs[] = { "", "M", "m", "S", "s", "X", "Y", "N", "0", "1", "2", "3", "4", "5", "6", "8", "10", "12", "15", "20", "21", "2x" };
+    const int NumInputs = sizeof(Inputs) / sizeof(Inputs[0]);
+}
+
+TEST_CASE("GameCoroutine")
+{
+    Map map;
+    RoomText roomText(map);
+
+    SECTION("Starts on first input")
+    {
+        XoshiroRandomSource randomSource(1);
+        Model model(randomSource, map);
+        GameCoroutine game = PlayGame(model, model);
+        REQUIRE(!game.IsOver());
+
+        const tokenvec& output = game.InputTokens(Interpreter::Randomize);
+        REQUIRE(output.size() > 2);
+        REQUIRE(output[0] == MsgToken(MsgId::HuntTheWumpus));
+        REQUIRE(output[1] == MsgToken(MsgId::Blank));
+    }
+
+    SECTION("Matches Interpreter")
+    {
+        // Two identical games, one per front end, fed the same random input.
+        XoshiroRandomSource inputSource(99);
+        for (uint64_t seed = 0; seed < 50; ++seed)
+        {
+            XoshiroRandomSource interpRandomSource(seed);
+            Model interpModel(interpRandomSource, map);
+            Interpreter interp(interpModel, interpModel, &roomText);
+
+            XoshiroRandomSource gameRandomSource(seed);
+            Model gameModel(gameRandomSource, map);
+            GameCoroutine game = PlayGame(gameModel, gameModel, &roomText);
+
+            REQUIRE(game.InputTokens(Interpreter::Randomize) == interp.InputTokens(Interpreter::Randomize));
+            for (int i = 0; i < 500 && !game.IsOver(); ++i)
+            {
+                const char* input = Inputs[inputSource.NextInt(0, NumInputs - 1)];
+                REQUIRE(game.InputTokens(input) == interp.InputTokens(input));
+                REQUIRE(game.IsOver() == interp.IsOver());
+            }
+        }
+    }
+
+    SECTION("No output once over")
+    {
+        XoshiroRandomSource randomSource(3);
+        Model model(randomSource, map);
+        GameCoroutine game = PlayGame(model, model);
+        game.InputTokens(Interpreter::Randomize);
+
+        // Only killing the wumpus ends a session.
+        model.SetPlayerRoom(1);
+        model.SetWumpusRoom(2);
+        model.SetBatRooms(19, 20);
+        model.SetPitRooms(19, 20);
+        game.InputTokens("S");
+        game.InputTokens("1");
+        REQUIRE(game.InputTokens("2") == tokenvec({ MsgId::Blank, MsgId::GotTheWumpus, MsgId::GetYouNextTime }));
+        REQUIRE(game.IsOver());
+        REQUIRE(game.InputTokens("M").empty());
+    }
+
+    SECTION("Move")
+    {
+        XoshiroRandomSource randomSource(5);
+        Model model(randomSource, map);
+        GameCoroutine game = PlayGame(model, model);
+        GameCoroutine moved = move(game);
+        REQUIRE(!moved.InputTokens(Interpreter::Randomize).empty());
+    }
+}
@@ -0,0 +1,80 @@
+#include "GameFarm.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+using namespace chrono;
+
+// A worker's share of the games. The owner and any thieves claim chunks from the same
+// counter, so stealing needs no locks: whoever bumps m_next past m_end first gets the
+// last chunk. Aligned to keep each counter on its own cache line.
+class alignas(64) GameFarm::Shard
+{
+public:
+    atomic<long long> m_next;
+    long long m_end;
+};
+
+const long long GameFarm::ChunkSize;
+
+GameFarm::GameFarm(PolicyFactory policyFactory, unsigned numWorkers)
+    : m_policyFactory(policyFactory)
+    , m_numWorkers(max(numWorkers, 1u))
+{
+}
+
+unsigned GameFarm::GetNumWorkers() const
+{
+    return m_numWorkers;
+}
+
+SimulationResults GameFarm::Run(long long numGames, int maxTurns)
+{
+    vector<Shard> shards(m_numWorkers);
+    for (unsigned i = 0; i < m_numWorkers; ++i)
+    {
+        shards[i].m_next = numGames * i / m_numWorkers;
+        shards[i].m_end = numGames * (i + 1) / m_numWorkers;
+    }
+
+    XoshiroRandomSource randomSource(static_cast<uint64_t>(system_clock::now().time_since_epoch().count()));
+    vector<SimulationResults> workerResults(m_numWorkers);
+    vector<thread> threads;
+    for (unsigned i = 0; i < m_numWorkers; ++i)
+    {
+        threads.emplace_back(&GameFarm::Work, this, i, ref(shards), randomSource, maxTurns, ref(workerResults[i]));
+        randomSource.Jump();
+    }
+
+    SimulationResults results;
+    for (unsigned i = 0; i < m_numWorkers; ++i)
+    {
+        threads[i].join();
+        results.Merge(workerResults[i]);
+    }
+    return results;
+}
+
+void GameFarm::Work(unsigned worker, vector<Shard>& shards, XoshiroRandomSource randomSource, int maxTurns, SimulationResults& results) const
+{
+    unique_ptr<Policy> policy = m_policyFactory(randomSource);
+    Simulator simulator(randomSource, *policy);
+
+    // Drain our own shard first, then steal from the others in turn.
+    for (unsigned i = 0; i < m_numWorkers; ++i)
+    {
+        Shard& shard = shards[(worker + i) % m_numWorkers];
+        for (long long games = ClaimChunk(shard); games > 0; games = ClaimChunk(shard))
+            results.Merge(simulator.Run(games, maxTurns));
+    }
+}
+
+long long GameFarm::ClaimChunk(Shard& shard)
+{
+    long long first = shard.m_next.fetch_add(ChunkSize);
+    if (first >= shard.m_end)
+        return 0;
+
+    return min(ChunkSize, shard.m_end - first);
+}
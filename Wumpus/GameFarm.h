@@ -0,0 +1,36 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <thread>
+#include "Policy.h"
+#include "RandomSource.h"
+#include "Simulator.h"
+#include "XoshiroRandomSource.h"
+
+// Runs a batch of simulated games on a pool of worker threads. Each worker owns its own
+// RandomSource (a jumped-ahead stream of one seed), Policy and Simulator (and therefore
+// Model), so nothing mutable is shared between threads except the game counters used to
+// hand out work.
+class GameFarm
+{
+public:
+    using PolicyFactory = function<unique_ptr<Policy>(RandomSource& randomSource)>;
+
+    static const long long ChunkSize = 1024;
+
+    GameFarm(PolicyFactory policyFactory, unsigned numWorkers = thread::hardware_concurrency());
+
+    unsigned GetNumWorkers() const;
+    SimulationResults Run(long long numGames, int maxTurns = Simulator::DefaultMaxTurns);
+
+private:
+    class Shard;
+
+    void Work(unsigned worker, vector<Shard>& shards, XoshiroRandomSource randomSource, int maxTurns, SimulationResults& results) const;
+    static long long ClaimChunk(Shard& shard);
+
+private:
+    PolicyFactory m_policyFactory;
+    unsigned m_numWorkers;
+};
@@ -0,0 +1,43 @@
+#include "catch.hpp"
+
+#include "GameFarm.h"
+#include "RandomPolicy.h"
+
+TEST_CASE("GameFarm")
+{
+    GameFarm farm([](RandomSource& randomSource) {
+        return unique_ptr<Policy>(new RandomPolicy(randomSource));
+    }, 4);
+
+    SECTION("At least one worker")
+    {
+        GameFarm empty([](RandomSource& randomSource) {
+            return unique_ptr<Policy>(new RandomPolicy(randomSource));
+        }, 0);
+        REQUIRE(empty.GetNumWorkers() == 1);
+    }
+
+    SECTION("Plays every game exactly once")
+    {
+        const long long numGames = 10 * GameFarm::ChunkSize + 7;
+        SimulationResults results = farm.Run(numGames);
+        REQUIRE(results.GetGames() == numGames);
+
+        long long total = 0;
+        for (int i = 0; i < SimulationResults::NumOutcomes; ++i)
+            total += results.GetCount(static_cast<Outcome>(i));
+        REQUIRE(total == numGames);
+    }
+
+    SECTION("Fewer games than workers")
+    {
+        SimulationResults results = farm.Run(3);
+        REQUIRE(results.GetGames() == 3);
+    }
+
+    SECTION("No games")
+    {
+        SimulationResults results = farm.Run(0);
+        REQUIRE(results.GetGames() == 0);
+    }
+}
@@ -0,0 +1,300 @@
+#include "GameServer.h"
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <chrono>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include "Session.h"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <system_error>
+#include <unistd.h>
+
+using namespace chrono;
+
+namespace
+{
+    [[noreturn]] void ThrowSystemError(const char* what)
+    {
+        throw system_error(errno, system_category(), what);
+    }
+}
+
+class GameServer::Connection
+{
+public:
+    Connection(int fd, const Map& map, const RoomText& roomText, uint64_t seed)
+        : m_fd(fd)
+        , m_session(map, roomText, seed)
+        , m_sent(0)
+        , m_blocked(false)
+    {
+    }
+
+    int m_fd;
+    Session m_session;
+
+    // Output not yet sent starts at m_sent. While m_blocked, we wait for the socket to
+    // become writable and don't read.
+    string m_output;
+    size_t m_sent;
+    bool m_blocked;
+};
+
+const int GameServer::MaxEvents;
+const int GameServer::ReadSize;
+const int GameServer::AcceptRetryMs;
+
+GameServer::GameServer(const Map& map, uint16_t port)
+    : GameServer(map, make_shared<Listener>(port), XoshiroRandomSource(system_clock::now().time_since_epoch().count()))
+{
+    m_sharedListener = false;
+}
+
+GameServer::GameServer(const Map& map, const string& socketPath)
+    : GameServer(map, make_shared<Listener>(socketPath), XoshiroRandomSource(system_clock::now().time_since_epoch().count()))
+{
+    m_sharedListener = false;
+}
+
+GameServer::GameServer(const Map& map, shared_ptr<const Listener> listener, const XoshiroRandomSource& seeds)
+    : m_map(map)
+    , m_roomText(map)
+    , m_seeds(seeds)
+    , m_listener(listener)
+    , m_sharedListener(true)
+    , m_epollFd(epoll_create1(EPOLL_CLOEXEC))
+    , m_stopFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+    , m_acceptPaused(false)
+{
+    if (!m_epollFd.IsValid())
+        ThrowSystemError("epoll_create1");
+    if (!m_stopFd.IsValid())
+        ThrowSystemError("eventfd");
+
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.ptr = &m_stopFd;
+    if (epoll_ctl(m_epollFd.Get(), EPOLL_CTL_ADD, m_stopFd.Get(), &event) < 0)
+        ThrowSystemError("epoll_ctl");
+
+    ResumeAccepting();
+}
+
+GameServer::~GameServer()
+{
+    for (auto& connection : m_connections)
+        close(connection.first);
+}
+
+uint16_t GameServer::GetPort() const
+{
+    return m_listener->GetPort();
+}
+
+size_t GameServer::GetNumSessions() const
+{
+    return m_connections.size();
+}
+
+void GameServer::Run()
+{
+    epoll_event events[MaxEvents];
+    for (;;)
+    {
+        int timeoutMs = -1;
+        if (m_acceptPaused)
+        {
+            auto wait = duration_cast<milliseconds>(m_acceptResumeTime - steady_clock::now()).count();
+            if (wait <= 0)
+            {
+                ResumeAccepting();
+                continue;
+            }
+            timeoutMs = static_cast<int>(wait);
+        }
+
+        int numEvents = epoll_wait(m_epollFd.Get(), events, MaxEvents, timeoutMs);
+        if (numEvents < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            ThrowSystemError("epoll_wait");
+        }
+
+        // A connection appears at most once per batch, so closing one can't leave a
+        // dangling pointer later in the batch.
+        for (int i = 0; i < numEvents; ++i)
+        {
+            void* source = events[i].data.ptr;
+            if (source == &m_stopFd)
+            {
+                uint64_t count;
+                while (read(m_stopFd.Get(), &count, sizeof(count)) > 0)
+                {
+                }
+                return;
+            }
+
+            if (source == &m_listener)
+            {
+                Accept();
+                continue;
+            }
+
+            Connection& connection = *static_cast<Connection*>(source);
+            if ((events[i].events & (EPOLLERR | EPOLLHUP)) != 0)
+                Close(connection);
+            else if (connection.m_blocked)
+                Flush(connection);
+            else
+                Read(connection);
+        }
+    }
+}
+
+void GameServer::Stop()
+{
+    uint64_t one = 1;
+    ssize_t written = write(m_stopFd.Get(), &one, sizeof(one));
+    (void)written;
+}
+
+void GameServer::Accept()
+{
+    do
+    {
+        int fd = accept4(m_listener->GetFd(), nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+
+            // The listener is level triggered, so while we can't take the connections
+            // still queued it would wake us again at once. Stop watching it for a while.
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM)
+                PauseAccepting();
+
+            // Otherwise nothing is pending; another server sharing the listener may have
+            // taken the connection first.
+            return;
+        }
+
+        // Turns are small request/response exchanges, so don't let Nagle hold them back.
+        // Fails harmlessly on Unix domain sockets.
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+        unique_ptr<Connection>& slot = m_connections[fd];
+        slot.reset(new Connection(fd, m_map, m_roomText, m_seeds.Next()));
+        Connection& connection = *slot;
+
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.ptr = &connection;
+        if (epoll_ctl(m_epollFd.Get(), EPOLL_CTL_ADD, fd, &event) < 0)
+        {
+            Close(connection);
+            continue;
+        }
+
+        connection.m_session.Start(connection.m_output);
+        Flush(connection);
+    } while (!m_sharedListener);
+}
+
+void GameServer::PauseAccepting()
+{
+    if (epoll_ctl(m_epollFd.Get(), EPOLL_CTL_DEL, m_listener->GetFd(), nullptr) < 0)
+        ThrowSystemError("epoll_ctl");
+    m_acceptPaused = true;
+    m_acceptResumeTime = steady_clock::now() + milliseconds(AcceptRetryMs);
+}
+
+void GameServer::ResumeAccepting()
+{
+    // With a shared listener, only one of the waiting servers is woken per connection.
+    epoll_event event = {};
+    event.events = EPOLLIN | EPOLLEXCLUSIVE;
+    event.data.ptr = &m_listener;
+    if (epoll_ctl(m_epollFd.Get(), EPOLL_CTL_ADD, m_listener->GetFd(), &event) < 0)
+        ThrowSystemError("epoll_ctl");
+    m_acceptPaused = false;
+}
+
+void GameServer::Read(Connection& connection)
+{
+    // Level triggered, so one read per event is enough: any more input is reported
+    // again by the next epoll_wait.
+    char buffer[ReadSize];
+    ssize_t received = read(connection.m_fd, buffer, sizeof(buffer));
+    if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        return;
+    if (received <= 0)
+    {
+        Close(connection);
+        return;
+    }
+
+    if (!connection.m_session.Receive(string_view(buffer, received), connection.m_output))
+    {
+        Close(connection);
+        return;
+    }
+    Flush(connection);
+}
+
+void GameServer::Flush(Connection& connection)
+{
+    string& output = connection.m_output;
+    while (connection.m_sent < output.size())
+    {
+        ssize_t sent = send(connection.m_fd, output.data() + connection.m_sent, output.size() - connection.m_sent, MSG_NOSIGNAL);
+        if (sent < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                Watch(connection, EPOLLOUT);
+                return;
+            }
+            Close(connection);
+            return;
+        }
+        connection.m_sent += sent;
+    }
+
+    output.clear();
+    connection.m_sent = 0;
+    if (connection.m_session.IsOver())
+        Close(connection);
+    else if (connection.m_blocked)
+        Watch(connection, EPOLLIN);
+}
+
+void GameServer::Watch(Connection& connection, uint32_t events)
+{
+    epoll_event event = {};
+    event.events = events;
+    event.data.ptr = &connection;
+    if (epoll_ctl(m_epollFd.Get(), EPOLL_CTL_MOD, connection.m_fd, &event) < 0)
+    {
+        Close(connection);
+        return;
+    }
+    connection.m_blocked = (events == EPOLLOUT);
+}
+
+void GameServer::Close(Connection& connection)
+{
+    // Closing the descriptor also removes it from the epoll set.
+    int fd = connection.m_fd;
+    close(fd);
+    m_connections.erase(fd);
+}
+
+#endif
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include "FileDescriptor.h"
+#include "Listener.h"
+#include "Map.h"
+#include "RoomText.h"
+#include "stdtypes.h"
+#include "XoshiroRandomSource.h"
+
+// Hosts many concurrent games on one thread: a Session per connection, driven by a
+// non-blocking epoll reactor instead of a process or thread per player. Sessions share
+// the server's Map text and draw their seeds from one generator. A server owns all of
+// its state, so servers on different threads share nothing but, optionally, a Listener
+// (see ShardedGameServer). Linux only.
+//
+// Output that a client is slow to take is buffered, and the connection is not read again
+// until it has been sent. A connection is closed when its game ends or the client hangs
+// up. If accepting fails for lack of descriptors or memory, the server stops watching the
+// listener for AcceptRetryMs instead of spinning on the connections still queued.
+class GameServer
+{
+public:
+    static const int MaxEvents = 256;
+    static const int ReadSize = 4096;
+    static const int AcceptRetryMs = 100;
+
+    // Listens for TCP connections on all interfaces. Port 0 picks a free port.
+    GameServer(const Map& map, uint16_t port);
+
+    // Listens on a Unix domain socket, replacing any file already at socketPath.
+    GameServer(const Map& map, const string& socketPath);
+
+    // Accepts connections from a listener that other servers may also be accepting from.
+    // Each wakeup takes just one connection, leaving the rest for the other servers.
+    GameServer(const Map& map, shared_ptr<const Listener> listener, const XoshiroRandomSource& seeds);
+
+    GameServer(const GameServer&) = delete;
+    GameServer& operator=(const GameServer&) = delete;
+    ~GameServer();
+
+    // The TCP port being listened on, or 0 for a Unix domain socket.
+    uint16_t GetPort() const;
+
+    // Serves connections until Stop is called.
+    void Run();
+
+    // Makes Run return. Safe to call from another thread or a signal handler.
+    void Stop();
+
+    // Only meaningful on the thread that calls Run, or while Run is not running.
+    size_t GetNumSessions() const;
+
+private:
+    class Connection;
+
+    void Accept();
+    void PauseAccepting();
+    void ResumeAccepting();
+    void Read(Connection& connection);
+    void Flush(Connection& connection);
+    void Watch(Connection& connection, uint32_t events);
+    void Close(Connection& connection);
+
+private:
+    Map m_map;
+    RoomText m_roomText;
+    XoshiroRandomSource m_seeds;
+    shared_ptr<const Listener> m_listener;
+    bool m_sharedListener;
+    FileDescriptor m_epollFd;
+    FileDescriptor m_stopFd;
+    bool m_acceptPaused;
+    chrono::steady_clock::time_point m_acceptResumeTime;
+    unordered_map<int, unique_ptr<Connection>> m_connections;
+};
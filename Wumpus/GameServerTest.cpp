@@ -0,0 +1,101 @@
+#include "catch.hpp"
+
+#ifdef __linux__
+
+#include "GameServer.h"
+#include "Msg.h"
+#include "ServerTestHelpers.h"
+#include <sys/resource.h>
+
+namespace {
+    string LastLine(const string& output)
+    {
+        return output.substr(output.rfind('\n') + 1);
+    }
+
+    double CpuSeconds()
+    {
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    }
+
+    void Send(int fd, const string& input)
+    {
+        REQUIRE(send(fd, input.data(), input.size(), 0) == static_cast<ssize_t>(input.size()));
+    }
+}
+
+TEST_CASE("GameServer")
+{
+    Map map;
+    GameServer server(map, 0);
+    REQUIRE(server.GetPort() != 0);
+    ServerThread<GameServer> serverThread(server);
+
+    // The opening placements are random, so the player may already be dead and asked
+    // about playing again. Any prompt answers "X" with HUH? and the same prompt.
+    SECTION("Plays over TCP")
+    {
+        int fd = ConnectTcp(server.GetPort());
+        string opening = ReadUntilPrompt(fd);
+        REQUIRE(opening.compare(0, Msg::HuntTheWumpus.size(), Msg::HuntTheWumpus) == 0);
+
+        Send(fd, "X\r\n");
+        REQUIRE(ReadUntilPrompt(fd) == string(Msg::Huh) + "\n" + LastLine(opening));
+        close(fd);
+    }
+
+    SECTION("Sessions are independent")
+    {
+        int fd1 = ConnectTcp(server.GetPort());
+        int fd2 = ConnectTcp(server.GetPort());
+        string prompt1 = LastLine(ReadUntilPrompt(fd1));
+        string prompt2 = LastLine(ReadUntilPrompt(fd2));
+
+        Send(fd2, "X\n");
+        REQUIRE(ReadUntilPrompt(fd2) == string(Msg::Huh) + "\n" + prompt2);
+        Send(fd1, "X\n");
+        REQUIRE(ReadUntilPrompt(fd1) == string(Msg::Huh) + "\n" + prompt1);
+        close(fd1);
+        close(fd2);
+    }
+
+    SECTION("Backs off while out of descriptors")
+    {
+        // Open the client socket, then lower the limit so the server's accept fails.
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        REQUIRE(fd >= 0);
+        int lowestFree = dup(0);
+        REQUIRE(lowestFree >= 0);
+        close(lowestFree);
+        rlimit limit;
+        REQUIRE(getrlimit(RLIMIT_NOFILE, &limit) == 0);
+        rlimit lowered = limit;
+        lowered.rlim_cur = lowestFree;
+        REQUIRE(setrlimit(RLIMIT_NOFILE, &lowered) == 0);
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(server.GetPort());
+        int connected = connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+
+        // A server spinning on the queued connection would burn the whole interval.
+        double cpuBefore = CpuSeconds();
+        this_thread::sleep_for(chrono::milliseconds(3 * GameServer::AcceptRetryMs));
+        double cpuUsed = CpuSeconds() - cpuBefore;
+        setrlimit(RLIMIT_NOFILE, &limit);
+        REQUIRE(connected == 0);
+        REQUIRE(cpuUsed < 0.1);
+
+        // Once descriptors are available again, the connection is served.
+        timeval timeout = { 5, 0 };
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        string opening = ReadUntilPrompt(fd);
+        REQUIRE(opening.compare(0, Msg::HuntTheWumpus.size(), Msg::HuntTheWumpus) == 0);
+        close(fd);
+    }
+}
+
+#endif
@@ -1,27 +1,18 @@
 #include "Interpreter.h"
 
-#include "Msg.h"
-#include <sstream>
+#include <algorithm>
+#include <cstring>
+#include "Exceptions.h"
+#include "ParseInt.h"
 
 const string Interpreter::Randomize = "[Randomize]";
 
-const map<Event, string> Interpreter::EventMsgs =
-{
-    { Event::BatSnatch, Msg::BatSnatch },
-    { Event::BumpedWumpus, Msg::BumpedWumpus },
-    { Event::EatenByWumpus, Msg::WumpusGotYou },
-    { Event::FellInPit, Msg::FellInPit },
-    { Event::KilledWumpus, Msg::GotTheWumpus },
-    { Event::MissedWumpus, Msg::Missed },
-    { Event::ShotSelf, Msg::HitYourself }
-};
-
 class Interpreter::State
 {
 public:
     virtual void OutputEntryMessage(Interpreter& interp) const = 0;
 
-    virtual const State& Input(string input, Interpreter& interp) const
+    virtual const State& Input(string_view input, Interpreter& interp) const
     {
         if (input == "")
             return *this;
@@ -29,7 +20,7 @@ public:
             return NonEmptyInput(input, interp);
     }
 
-    virtual const State& NonEmptyInput(string input, Interpreter& interp) const
+    virtual const State& NonEmptyInput(string_view input, Interpreter& interp) const
     {
         return *this;
     }
@@ -39,51 +30,51 @@ class Interpreter::InitialState : public State
 {
 public:
     void OutputEntryMessage(Interpreter& interp) const override;
-    const State& Input(string input, Interpreter& interp) const override;
+    const State& Input(string_view input, Interpreter& interp) const override;
 };
 
 class Interpreter::AwaitingCommandState : public State
 {
 public:
     void OutputEntryMessage(Interpreter& interp) const override;
-    const State& NonEmptyInput(string input, Interpreter& interp) const override;
+    const State& NonEmptyInput(string_view input, Interpreter& interp) const override;
 };
 
 class Interpreter::AwaitingMoveRoomState : public State
 {
 public:
     void OutputEntryMessage(Interpreter& interp) const override;
-    const State& NonEmptyInput(string input, Interpreter& interp) const override;
+    const State& NonEmptyInput(string_view input, Interpreter& interp) const override;
 
 private:
-    const State& MovePlayer(const string& input, Interpreter& interp) const;
+    const State& MovePlayer(int room, Interpreter& interp) const;
 };
 
 class Interpreter::AwaitingArrowPathLengthState : public State
 {
 public:
     void OutputEntryMessage(Interpreter& interp) const override;
-    const State& NonEmptyInput(string input, Interpreter& interp) const override;
+    const State& NonEmptyInput(string_view input, Interpreter& interp) const override;
 
 private:
-    const State& PrepareArrow(const string& input, Interpreter& interp) const;
+    const State& PrepareArrow(int pathLength, Interpreter& interp) const;
 };
 
 class Interpreter::AwaitingArrowRoomState : public State
 {
 public:
     void OutputEntryMessage(Interpreter& interp) const override;
-    const State& NonEmptyInput(string input, Interpreter& interp) const override;
+    const State& NonEmptyInput(string_view input, Interpreter& interp) const override;
 
 private:
-    const State& MoveArrow(const string& input, Interpreter& interp) const;
+    const State& MoveArrow(int room, Interpreter& interp) const;
 };
 
 class Interpreter::AwaitingReplayState : public State
 {
 public:
     void OutputEntryMessage(Interpreter& interp) const override;
-    const State& NonEmptyInput(string input, Interpreter& interp) const override;
+    const State& NonEmptyInput(string_view input, Interpreter& interp) const override;
 
 private:
     const State& StartGame(const eventvec& events, Interpreter& interp) const;
@@ -93,7 +84,7 @@ class Interpreter::EndState : public State
 {
 public:
     void OutputEntryMessage(Interpreter& interp) const override {}
-    const State& NonEmptyInput(string input, Interpreter& interp) const override { return *this; }
+    const State& NonEmptyInput(string_view input, Interpreter& interp) const override { return *this; }
 };
 
 Interpreter::InitialState Interpreter::Initial;
@@ -104,9 +95,21 @@ Interpreter::AwaitingArrowRoomState Interpreter::AwaitingArrowRoom;
 Interpreter::AwaitingReplayState Interpreter::AwaitingReplay;
 Interpreter::EndState Interpreter::End;
 
-Interpreter::Interpreter(Commands& commands, const PlayerState& playerState)
+const Interpreter::State* const Interpreter::States[] =
+{
+    &Initial,
+    &AwaitingCommand,
+    &AwaitingMoveRoom,
+    &AwaitingArrowPathLength,
+    &AwaitingArrowRoom,
+    &AwaitingReplay,
+    &End
+};
+
+Interpreter::Interpreter(Commands& commands, const PlayerState& playerState, const RoomText* roomText)
     : m_commands(commands)
     , m_playerState(playerState)
+    , m_roomText(roomText)
     , m_state(&Initial)
 {
 }
@@ -116,19 +119,82 @@ void Interpreter::Run(istream& in, ostream& out)
     string input = Randomize;
     while (m_state != &End && !in.eof())
     {
-        strvec output = Input(input);
+        const tokenvec& output = InputTokens(input);
         for (size_t i = 0; i < output.size(); ++i)
         {
             if (i > 0)
                 out << endl;
-            out << output[i];
+            output[i].Render(out);
         }
         if (m_state != &End)
             getline(in, input);
     }
 }
 
+void Interpreter::AppendOutput(const tokenvec& tokens, string& output)
+{
+    for (size_t i = 0; i < tokens.size(); ++i)
+    {
+        if (i > 0)
+            output += '\n';
+        tokens[i].Render(output);
+    }
+}
+
 strvec Interpreter::Input(string input)
+{
+    const tokenvec& tokens = InputTokens(input);
+    strvec output;
+    output.reserve(tokens.size());
+    for (const MsgToken& token : tokens)
+        output.push_back(token.Render());
+    return output;
+}
+
+void Interpreter::RunBatch(istream& in, ostream& out)
+{
+    string output;
+    AppendOutput(InputTokens(Randomize), output);
+
+    // Lines are processed in place in the block they were read into; only a line that
+    // straddles two blocks is copied, into partialLine.
+    vector<char> block(BatchBlockSize);
+    string partialLine;
+    while (m_state != &End && in.read(block.data(), block.size()).gcount() > 0)
+    {
+        const char* next = block.data();
+        const char* blockEnd = next + in.gcount();
+        while (m_state != &End)
+        {
+            const char* newline = static_cast<const char*>(memchr(next, '\n', blockEnd - next));
+            if (newline == nullptr)
+            {
+                partialLine.append(next, blockEnd);
+                break;
+            }
+
+            string_view line(next, newline - next);
+            if (!partialLine.empty())
+            {
+                partialLine.append(line.data(), line.size());
+                line = partialLine;
+            }
+            AppendOutput(InputTokens(line), output);
+            partialLine.clear();
+            next = newline + 1;
+        }
+
+        out.write(output.data(), output.size());
+        out.flush();
+        output.clear();
+    }
+
+    // Like Run, a final line with no newline is not processed.
+    out.write(output.data(), output.size());
+    out.flush();
+}
+
+const tokenvec& Interpreter::InputTokens(string_view input)
 {
     m_output.clear();
     m_state = &m_state->Input(input, *this);
@@ -136,13 +202,41 @@ strvec Interpreter::Input(string input)
     return m_output;
 }
 
+void Interpreter::InputBatch(span<const string_view> lines, string& output)
+{
+    for (string_view line : lines)
+        AppendOutput(InputTokens(line), output);
+}
+
+bool Interpreter::IsOver() const
+{
+    return m_state == &End;
+}
+
+void Interpreter::Save(Snapshot& snapshot) const
+{
+    snapshot.m_interpreterState = static_cast<uint8_t>(find(begin(States), end(States), m_state) - begin(States));
+}
+
+void Interpreter::Restore(const Snapshot& snapshot)
+{
+    ValidateSnapshot(snapshot);
+    m_state = States[snapshot.m_interpreterState];
+}
+
+void Interpreter::ValidateSnapshot(const Snapshot& snapshot)
+{
+    if (snapshot.m_interpreterState >= size(States))
+        throw SnapshotException();
+}
+
 void Interpreter::InitialState::OutputEntryMessage(Interpreter& interp) const
 {
 }
 
-const Interpreter::State& Interpreter::InitialState::Input(string input, Interpreter& interp) const
+const Interpreter::State& Interpreter::InitialState::Input(string_view input, Interpreter& interp) const
 {
-    interp.Output(Msg::HuntTheWumpus);
+    interp.Output(MsgId::HuntTheWumpus);
 
     if (input == Randomize)
     {
@@ -157,10 +251,10 @@ const Interpreter::State& Interpreter::InitialState::Input(string input, Interpr
 
 void Interpreter::AwaitingCommandState::OutputEntryMessage(Interpreter& interp) const
 {
-    interp.Output(Msg::ShootOrMove);
+    interp.Output(MsgId::ShootOrMove);
 }
 
-const Interpreter::State& Interpreter::AwaitingCommandState::NonEmptyInput(string input, Interpreter& interp) const
+const Interpreter::State& Interpreter::AwaitingCommandState::NonEmptyInput(string_view input, Interpreter& interp) const
 {
     if (input == "M" || input == "m")
     {
@@ -172,107 +266,112 @@ const Interpreter::State& Interpreter::AwaitingCommandState::NonEmptyInput(strin
     }
     else
     {
-        interp.Output(Msg::Huh);
+        interp.Output(MsgId::Huh);
         return *this;
     }
 }
 
 void Interpreter::AwaitingMoveRoomState::OutputEntryMessage(Interpreter& interp) const
 {
-    interp.Output(Msg::WhereTo);
+    interp.Output(MsgId::WhereTo);
 }
 
-const Interpreter::State& Interpreter::AwaitingMoveRoomState::NonEmptyInput(string input, Interpreter& interp) const
+const Interpreter::State& Interpreter::AwaitingMoveRoomState::NonEmptyInput(string_view input, Interpreter& interp) const
 {
-    try
+    int room;
+    if (!ParseInt(input, room))
     {
-        return MovePlayer(input, interp);
-    }
-    catch (const exception&)
-    {
-        interp.Output(Msg::Huh);
+        interp.Output(MsgId::Huh);
         return *this;
     }
-    catch (const GameException&)
+
+    return MovePlayer(room, interp);
+}
+
+const Interpreter::State& Interpreter::AwaitingMoveRoomState::MovePlayer(int room, Interpreter& interp) const
+{
+    EventVecSink events(interp.ClearEvents());
+    if (interp.m_commands.TryMovePlayer(room, events) != CommandStatus::Ok)
     {
-        interp.Output(Msg::Impossible);
+        interp.Output(MsgId::Impossible);
         return *this;
     }
-}
 
-const Interpreter::State& Interpreter::AwaitingMoveRoomState::MovePlayer(const string& input, Interpreter& interp) const
-{
-    eventvec events = interp.m_commands.MovePlayer(stoi(input));
-    return interp.CheckAndOutputPlayerState(events);
+    return interp.CheckAndOutputPlayerState(interp.m_events);
 }
 
 void Interpreter::AwaitingArrowPathLengthState::OutputEntryMessage(Interpreter& interp) const
 {
-    interp.Output(Msg::NumberOfRooms);
+    interp.Output(MsgId::NumberOfRooms);
 }
 
-const Interpreter::State& Interpreter::AwaitingArrowPathLengthState::NonEmptyInput(string input, Interpreter& interp) const
+const Interpreter::State& Interpreter::AwaitingArrowPathLengthState::NonEmptyInput(string_view input, Interpreter& interp) const
 {
-    try
+    int pathLength;
+    if (!ParseInt(input, pathLength))
     {
-        return PrepareArrow(input, interp);
-    }
-    catch (const exception&)
-    {
-        interp.Output(Msg::Huh);
+        interp.Output(MsgId::Huh);
         return *this;
     }
-    catch (const ArrowPathLengthException&)
+
+    return PrepareArrow(pathLength, interp);
+}
+
+const Interpreter::State& Interpreter::AwaitingArrowPathLengthState::PrepareArrow(int pathLength, Interpreter& interp) const
+{
+    if (interp.m_commands.TryPrepareArrow(pathLength) != CommandStatus::Ok)
     {
-        interp.Output(Msg::Impossible);
+        interp.Output(MsgId::Impossible);
         return *this;
     }
-}
 
-const Interpreter::State& Interpreter::AwaitingArrowPathLengthState::PrepareArrow(const string& input, Interpreter& interp) const
-{
-    interp.m_commands.PrepareArrow(stoi(input));
     return AwaitingArrowRoom;
 }
 
 void Interpreter::AwaitingArrowRoomState::OutputEntryMessage(Interpreter& interp) const
 {
-    interp.Output(Msg::RoomNumber);
+    interp.Output(MsgId::RoomNumber);
 }
 
-const Interpreter::State& Interpreter::AwaitingArrowRoomState::NonEmptyInput(string input, Interpreter& interp) const
+const Interpreter::State& Interpreter::AwaitingArrowRoomState::NonEmptyInput(string_view input, Interpreter& interp) const
 {
-    try
+    int room;
+    if (!ParseInt(input, room))
     {
-        return MoveArrow(input, interp);
+        interp.Output(MsgId::Huh);
+        return *this;
     }
-    catch (const exception&)
+
+    return MoveArrow(room, interp);
+}
+
+const Interpreter::State& Interpreter::AwaitingArrowRoomState::MoveArrow(int room, Interpreter& interp) const
+{
+    EventVecSink events(interp.ClearEvents());
+    CommandStatus status = interp.m_commands.TryMoveArrow(room, events);
+    if (status == CommandStatus::ArrowDoubleBack)
     {
-        interp.Output(Msg::Huh);
+        interp.Output(MsgId::NotThatCrooked);
         return *this;
     }
-    catch (const ArrowDoubleBackException&)
+    else if (status != CommandStatus::Ok)
     {
-        interp.Output(Msg::NotThatCrooked);
+        interp.Output(MsgId::Impossible);
         return *this;
     }
-}
 
-const Interpreter::State& Interpreter::AwaitingArrowRoomState::MoveArrow(const string& input, Interpreter& interp) const
-{
-    eventvec events = interp.m_commands.MoveArrow(stoi(input));
-    if (events.empty())
+    if (interp.m_events.empty())
         return *this;
 
-    return interp.CheckAndOutputPlayerState(events);
+    return interp.CheckAndOutputPlayerState(interp.m_events);
 }
 
 void Interpreter::AwaitingReplayState::OutputEntryMessage(Interpreter& interp) const
 {
-    interp.Output(Msg::SameSetup);
+    interp.Output(MsgId::SameSetup);
 }
 
-const Interpreter::State& Interpreter::AwaitingReplayState::NonEmptyInput(string input, Interpreter& interp) const
+const Interpreter::State& Interpreter::AwaitingReplayState::NonEmptyInput(string_view input, Interpreter& interp) const
 {
     if (input == "Y" || input == "y")
     {
@@ -286,20 +385,20 @@ const Interpreter::State& Interpreter::AwaitingReplayState::NonEmptyInput(string
     }
     else
     {
-        interp.Output(Msg::Huh);
+        interp.Output(MsgId::Huh);
         return *this;
     }
 }
 
 const Interpreter::State& Interpreter::AwaitingReplayState::StartGame(const eventvec& events, Interpreter& interp) const
 {
-    interp.Output(Msg::HuntTheWumpus);
+    interp.Output(MsgId::HuntTheWumpus);
     return interp.CheckAndOutputPlayerState(events);
 }
 
 const Interpreter::State& Interpreter::CheckAndOutputPlayerState(const eventvec& events)
 {
-    Output("");
+    Output(MsgId::Blank);
     OutputEvents(events);
 
     if (!m_playerState.WumpusAlive())
@@ -314,20 +413,20 @@ const Interpreter::State& Interpreter::CheckAndOutputPlayerState(const eventvec&
 
 const Interpreter::State& Interpreter::WumpusDied()
 {
-    Output(Msg::GetYouNextTime);
+    Output(MsgId::GetYouNextTime);
     return End;
 }
 
 const Interpreter::State& Interpreter::PlayerDied()
 {
-    Output(Msg::YouLose);
+    Output(MsgId::YouLose);
     return AwaitingReplay;
 }
 
 const Interpreter::State& Interpreter::OutOfArrows()
 {
-    Output(Msg::OutOfArrows);
-    Output(Msg::YouLose);
+    Output(MsgId::OutOfArrows);
+    Output(MsgId::YouLose);
     return AwaitingReplay;
 }
 
@@ -335,37 +434,49 @@ const Interpreter::State& Interpreter::PlayerStillAlive()
 {
     OutputAdjacentHazards();
     OutputPlayerLocation();
-    Output("");
+    Output(MsgId::Blank);
     return AwaitingCommand;
 }
 
 void Interpreter::OutputEvents(const eventvec& events)
 {
     for (Event event : events)
-        Output(EventMsgs.at(event));
+        Output(EventMsg(event));
 }
 
 void Interpreter::OutputAdjacentHazards()
 {
     if (m_playerState.WumpusAdjacent())
-        Output(Msg::SmellWumpus);
+        Output(MsgId::SmellWumpus);
     if (m_playerState.BatsAdjacent())
-        Output(Msg::BatsNearby);
+        Output(MsgId::BatsNearby);
     if (m_playerState.PitAdjacent())
-        Output(Msg::FeelDraft);
+        Output(MsgId::FeelDraft);
 }
 
 void Interpreter::OutputPlayerLocation()
 {
-    Output(Msg::YouAreInRoom + to_string(m_playerState.GetPlayerRoom()));
-
+    int room = m_playerState.GetPlayerRoom();
     ints3 connected = m_playerState.GetPlayerConnectedRooms();
-    ostringstream out2;
-    out2 << Msg::TunnelsLeadTo << connected[0] << " " << connected[1] << " " << connected[2];
-    Output(out2.str());
+    if (m_roomText != nullptr)
+    {
+        Output(MsgToken(MsgId::YouAreInRoom, room, m_roomText->GetLocation(room)));
+        Output(MsgToken(MsgId::TunnelsLeadTo, connected, m_roomText->GetTunnels(room)));
+    }
+    else
+    {
+        Output(MsgToken(MsgId::YouAreInRoom, room));
+        Output(MsgToken(MsgId::TunnelsLeadTo, connected));
+    }
+}
+
+eventvec& Interpreter::ClearEvents()
+{
+    m_events.clear();
+    return m_events;
 }
 
-void Interpreter::Output(const string& str)
+void Interpreter::Output(const MsgToken& token)
 {
-    m_output.push_back(str);
+    m_output.push_back(token);
 }
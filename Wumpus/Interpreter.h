@@ -1,20 +1,56 @@
 #pragma once
 
 #include <iostream>
+#include <span>
+#include <string_view>
 #include "Model.h"
+#include "MsgToken.h"
+#include "RoomText.h"
+#include "Snapshot.h"
 #include "stdtypes.h"
 
 class Interpreter
 {
 public:
     static const string Randomize;
-    static const map<Event, string> EventMsgs;
+    static const int BatchBlockSize = 1 << 16;
 
-    Interpreter(Commands& commands, const PlayerState& playerState);
+    // If given, roomText must describe the same Map as playerState, and is used for the
+    // player location lines instead of formatting them each turn.
+    Interpreter(Commands& commands, const PlayerState& playerState, const RoomText* roomText = nullptr);
 
     void Run(istream& in, ostream& out);
+
+    // Non-interactive version of Run for scripted input. Reads input in large blocks and
+    // writes the same output as Run, but flushes once per block instead of once per line.
+    // Unlike Run, it may read past the input that ends the game.
+    void RunBatch(istream& in, ostream& out);
     strvec Input(string input);
 
+    // Like Input, but produces message tokens instead of text, in a buffer that is reused
+    // by the next call.
+    const tokenvec& InputTokens(string_view input);
+
+    // Runs several lines through in one call, e.g. a whole pipelined turn, appending the
+    // text for all of them to output as RunBatch would write it.
+    void InputBatch(span<const string_view> lines, string& output);
+
+    // True once the wumpus has been killed, which ends the session; no further input is
+    // accepted. Other outcomes offer a new game instead.
+    bool IsOver() const;
+
+    // Fills in or restores the Interpreter's part of a snapshot, which is which prompt it
+    // is waiting on. The Model's part must be restored too.
+    void Save(Snapshot& snapshot) const;
+    void Restore(const Snapshot& snapshot);
+
+    // Throws SnapshotException if Restore would reject the snapshot, without restoring it.
+    static void ValidateSnapshot(const Snapshot& snapshot);
+
+    // Renders tokens as text in the same layout as Run: lines separated by newlines,
+    // with none after the last.
+    static void AppendOutput(const tokenvec& tokens, string& output);
+
 private:
     class State;
     class InitialState;
@@ -34,13 +70,16 @@ private:
     void OutputEvents(const eventvec& events);
     void OutputAdjacentHazards();
     void OutputPlayerLocation();
-    void Output(const string& str);
+    void Output(const MsgToken& token);
+    eventvec& ClearEvents();
 
 private:
     Commands& m_commands;
     const PlayerState& m_playerState;
+    const RoomText* m_roomText;
     const State* m_state;
-    strvec m_output;
+    tokenvec m_output;
+    eventvec m_events;
 
     static InitialState Initial;
     static AwaitingCommandState AwaitingCommand;
@@ -49,4 +88,7 @@ private:
     static AwaitingArrowRoomState AwaitingArrowRoom;
     static AwaitingReplayState AwaitingReplay;
     static EndState End;
+
+    // Indexed by Snapshot::m_interpreterState.
+    static const State* const States[];
 };
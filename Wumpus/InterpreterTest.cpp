@@ -23,6 +23,8 @@ public:
             throw PlayerDeadException();
         if (willThrowRoomsNotConnectedException)
             throw RoomsNotConnectedException();
+        if (willThrowTunnelCountException)
+            throw TunnelCountException();
 
         invoked.push_back("MovePlayer " + to_string(room));
         return PostClearEvents();
@@ -73,6 +75,7 @@ public:
     bool willThrowRoomsNotConnectedException = false;
     bool willThrowArrowPathLengthException = false;
     bool willThrowArrowDoubleBackException = false;
+    bool willThrowTunnelCountException = false;
     eventvec events = {};
 };
 
@@ -128,30 +131,33 @@ public:
 };
 
 namespace {
+    // Expected output lines, which may be Msg constants.
+    using msgvec = vector<string_view>;
+
     void RequireCommands(const CommandsSpy& commands, const strvec& invoked)
     {
         REQUIRE(commands.invoked == invoked);
     }
 
-    void RequireOutput(const strvec& output, const strvec& msgs)
+    void RequireOutput(const strvec& output, const msgvec& msgs)
     {
-        REQUIRE(output == msgs);
+        REQUIRE(output == strvec(msgs.begin(), msgs.end()));
     }
 
-    void RequireOutput(const strvec& output, const strvec& msgs, unsigned& outputIndex)
+    void RequireOutput(const strvec& output, const msgvec& msgs, unsigned& outputIndex)
     {
         for (unsigned i = 0; i < msgs.size(); ++i)
             REQUIRE(output[outputIndex++] == msgs[i]);
     }
 
-    void RequireNextMoveOutput(const strvec& output, const strvec& leadingMsgs)
+    void RequireNextMoveOutput(const strvec& output, const msgvec& leadingMsgs)
     {
         REQUIRE(output.size() >= leadingMsgs.size());
         unsigned outputIndex = 0;
         RequireOutput(output, leadingMsgs, outputIndex);
         RequireOutput(output, {
-            Msg::YouAreInRoom + "1",
-            Msg::TunnelsLeadTo + "2 3 4",
+            string(Msg::YouAreInRoom) + "1",
+            string(Msg::TunnelsLeadTo) + "2 3 4",
             "",
             Msg::ShootOrMove
         }, outputIndex);
@@ -496,6 +502,75 @@ TEST_CASE("Interpreter")
         }
     }
 
+    SECTION("Message tokens")
+    {
+        const tokenvec& output = interp.InputTokens("");
+        REQUIRE(output == tokenvec({
+            MsgId::HuntTheWumpus,
+            MsgId::Blank,
+            MsgToken(MsgId::YouAreInRoom, 1),
+            MsgToken(MsgId::TunnelsLeadTo, ints3({ 2, 3, 4 })),
+            MsgId::Blank,
+            MsgId::ShootOrMove
+        }));
+
+        SECTION("Room text")
+        {
+            Map map(4, { { 1, 2 }, { 1, 3 }, { 1, 4 } });
+            RoomText roomText(map);
+            Interpreter cachedInterp(commands, playerState, &roomText);
+            RequireOutput(cachedInterp.Input(""), {
+                Msg::HuntTheWumpus,
+                "",
+                string(Msg::YouAreInRoom) + "1",
+                string(Msg::TunnelsLeadTo) + "2 3 4",
+                "",
+                Msg::ShootOrMove
+            });
+        }
+
+        SECTION("Buffer is reused")
+        {
+            const tokenvec& next = interp.InputTokens("X");
+            REQUIRE(&next == &output);
+            REQUIRE(next == tokenvec({ MsgId::Huh, MsgId::ShootOrMove }));
+        }
+    }
+
+    SECTION("Input batch")
+    {
+        CommandsSpy lineCommands;
+        PlayerStateStub linePlayerState;
+        Interpreter lineInterp(lineCommands, linePlayerState);
+        interp.Input("");
+        lineInterp.Input("");
+
+        const string_view turn[] = { "S", "3", "2", "10", "11", "X" };
+        string expected = "EARLIER OUTPUT";
+        for (string_view line : turn)
+            Interpreter::AppendOutput(lineInterp.InputTokens(line), expected);
+
+        string output = "EARLIER OUTPUT";
+        interp.InputBatch(turn, output);
+        REQUIRE(output == expected);
+        REQUIRE(commands.invoked == lineCommands.invoked);
+    }
+
+    SECTION("Snapshot")
+    {
+        interp.Input("");
+        interp.Input("S");
+        Snapshot snapshot = {};
+        interp.Save(snapshot);
+
+        Interpreter restored(commands, playerState);
+        restored.Restore(snapshot);
+        RequireOutput(restored.Input("X"), { Msg::Huh, Msg::NumberOfRooms });
+
+        snapshot.m_interpreterState = 100;
+        REQUIRE_THROWS_AS(restored.Restore(snapshot), SnapshotException);
+    }
+
     SECTION("Stream I/O")
     {
         stringstream in;
@@ -519,6 +594,37 @@ TEST_CASE("Interpreter")
             REQUIRE(out.str() == expected.str());
         }
 
+        SECTION("Batch output matches Run")
+        {
+            // Long enough for lines to straddle input blocks.
+            string script;
+            while (script.size() < 3 * Interpreter::BatchBlockSize)
+                script += "M\nX\n5\nS\n\n";
+            script += "M";
+
+            CommandsSpy batchCommands;
+            PlayerStateStub batchPlayerState;
+            Interpreter batchInterp(batchCommands, batchPlayerState);
+            istringstream batchIn(script);
+            ostringstream batchOut;
+            batchInterp.RunBatch(batchIn, batchOut);
+
+            in << script;
+            interp.Run(in, out);
+
+            REQUIRE(batchOut.str() == out.str());
+            REQUIRE(batchCommands.invoked == commands.invoked);
+        }
+
+        SECTION("Batch stops at game end")
+        {
+            in << "M\n2\nM\n3\n";
+            playerState.wumpusAlive = false;
+            interp.RunBatch(in, out);
+            REQUIRE(out.str() == string(Msg::HuntTheWumpus) + "\n\n" + string(Msg::GetYouNextTime));
+            RequireCommands(commands, { "RandomPlacements" });
+        }
+
         SECTION("Run loop exits at game end")
         {
             in << "EXTRA" << endl;
@@ -532,3 +638,28 @@ TEST_CASE("Interpreter")
         }
     }
 }
+
+TEST_CASE("Commands default Try versions")
+{
+    CommandsSpy commands;
+    EventBuffer events;
+
+    SECTION("Ok")
+    {
+        REQUIRE(commands.TryMovePlayer(2, events) == CommandStatus::Ok);
+        RequireCommands(commands, { "MovePlayer 2" });
+    }
+
+    SECTION("Exception with a status")
+    {
+        commands.willThrowRoomsNotConnectedException = true;
+        REQUIRE(commands.TryMovePlayer(2, events) == CommandStatus::RoomsNotConnected);
+    }
+
+    SECTION("Other game exception")
+    {
+        commands.willThrowTunnelCountException = true;
+        REQUIRE(commands.TryMovePlayer(2, events) == CommandStatus::Failed);
+        REQUIRE_THROWS_AS(ThrowIfFailed(CommandStatus::Failed), GameException);
+    }
+}
@@ -0,0 +1,83 @@
+#include "Listener.h"
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <system_error>
+#include <unistd.h>
+
+Listener::Listener(uint16_t port)
+    : m_fd(-1)
+    , m_port(0)
+{
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    Listen(AF_INET, &address, sizeof(address));
+
+    socklen_t addressSize = sizeof(address);
+    if (getsockname(m_fd, reinterpret_cast<sockaddr*>(&address), &addressSize) < 0)
+    {
+        int error = errno;
+        close(m_fd);
+        throw system_error(error, system_category(), "getsockname");
+    }
+    m_port = ntohs(address.sin_port);
+}
+
+Listener::Listener(const string& socketPath)
+    : m_fd(-1)
+    , m_port(0)
+{
+    sockaddr_un address = {};
+    if (socketPath.size() >= sizeof(address.sun_path))
+        throw system_error(make_error_code(errc::filename_too_long), socketPath);
+
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+    unlink(socketPath.c_str());
+    Listen(AF_UNIX, &address, sizeof(address));
+    m_socketPath = socketPath;
+}
+
+Listener::~Listener()
+{
+    close(m_fd);
+    if (!m_socketPath.empty())
+        unlink(m_socketPath.c_str());
+}
+
+void Listener::Listen(int domain, const void* address, unsigned addressSize)
+{
+    m_fd = socket(domain, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_fd < 0)
+        throw system_error(errno, system_category(), "socket");
+
+    int on = 1;
+    if (domain == AF_INET)
+        setsockopt(m_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+    if (bind(m_fd, static_cast<const sockaddr*>(address), addressSize) < 0 || listen(m_fd, SOMAXCONN) < 0)
+    {
+        int error = errno;
+        close(m_fd);
+        throw system_error(error, system_category(), "listen");
+    }
+}
+
+int Listener::GetFd() const
+{
+    return m_fd;
+}
+
+uint16_t Listener::GetPort() const
+{
+    return m_port;
+}
+
+#endif
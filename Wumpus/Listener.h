@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include "stdtypes.h"
+
+// A non-blocking listening socket, TCP or Unix domain, for GameServers to accept
+// connections from. Several GameServers on different threads may share one. Linux only.
+class Listener
+{
+public:
+    // Listens on all interfaces. Port 0 picks a free port.
+    explicit Listener(uint16_t port);
+
+    // Replaces any file already at socketPath, and removes it again when destroyed.
+    explicit Listener(const string& socketPath);
+
+    Listener(const Listener&) = delete;
+    Listener& operator=(const Listener&) = delete;
+    ~Listener();
+
+    int GetFd() const;
+
+    // The TCP port being listened on, or 0 for a Unix domain socket.
+    uint16_t GetPort() const;
+
+private:
+    void Listen(int domain, const void* address, unsigned addressSize);
+
+private:
+    int m_fd;
+    uint16_t m_port;
+    string m_socketPath;
+};
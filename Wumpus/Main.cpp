@@ -1,10 +1,30 @@
 #define CATCH_CONFIG_RUNNER
 #include "catch.hpp"
 
+#include <chrono>
+#include "GameFarm.h"
 #include "Interpreter.h"
 #include <iostream>
 #include "Model.h"
+#include "ParseInt.h"
+#include "RandomPolicy.h"
+#include "RoomText.h"
+#include "ShardedGameServer.h"
 #include "SimpleRandomSource.h"
+#include "Simulator.h"
+
+namespace
+{
+    const map<Outcome, string> OutcomeNames =
+    {
+        { Outcome::KilledWumpus, "Killed wumpus" },
+        { Outcome::EatenByWumpus, "Eaten by wumpus" },
+        { Outcome::FellInPit, "Fell in pit" },
+        { Outcome::ShotSelf, "Shot self" },
+        { Outcome::OutOfArrows, "Out of arrows" },
+        { Outcome::TurnLimit, "Turn limit" }
+    };
+}
 
 int RunTests()
 {
@@ -14,15 +34,106 @@ int RunTests()
 int RunGame()
 {
     SimpleRandomSource randomSource;
-    Model model(randomSource);
-    Interpreter interp(model, model);
+    const Map& map = Map::Classic();
+    Model model(randomSource, map);
+    RoomText roomText(map);
+    Interpreter interp(model, model, &roomText);
 
     model.RandomPlacements();
     interp.Run(cin, cout);
     return 0;
 }
 
+int RunScript()
+{
+    SimpleRandomSource randomSource;
+    const Map& map = Map::Classic();
+    Model model(randomSource, map);
+    RoomText roomText(map);
+    Interpreter interp(model, model, &roomText);
+
+    model.RandomPlacements();
+    interp.RunBatch(cin, cout);
+    return 0;
+}
+
+int RunSimulation(long long numGames)
+{
+    GameFarm farm([](RandomSource& randomSource) {
+        return unique_ptr<Policy>(new RandomPolicy(randomSource));
+    });
+
+    SimulationResults results = farm.Run(numGames);
+    cout << "Games: " << results.GetGames() << endl;
+    cout << "Turns: " << results.GetTurns() << endl;
+    for (const auto& outcomeName : OutcomeNames)
+        cout << outcomeName.second << ": " << results.GetCount(outcomeName.first) << endl;
+    return 0;
+}
+
+// Times the room number parsing used by the Interpreter against the stoi and catch it
+// replaced, on a mix of numbers and the junk that bots and fuzzers send.
+int RunParseBenchmark(long long numLines)
+{
+    const strvec lines = { "12", "M", "5", "HELP", "", "3x", "ROOM", "20", "?", "-1" };
+
+    auto time = [&](const char* name, bool (*parse)(const string&, int&)) {
+        auto start = chrono::steady_clock::now();
+        long long parsed = 0;
+        int value;
+        for (long long i = 0; i < numLines; ++i)
+            parsed += parse(lines[i % lines.size()], value) ? value : 0;
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << name << ": " << seconds * 1e9 / numLines << " ns/line (checksum " << parsed << ")" << endl;
+    };
+
+    time("stoi", [](const string& line, int& value) {
+        try
+        {
+            value = stoi(line);
+            return true;
+        }
+        catch (const exception&)
+        {
+            return false;
+        }
+    });
+    time("ParseInt", [](const string& line, int& value) {
+        return ParseInt(line, value);
+    });
+    return 0;
+}
+
+#ifdef __linux__
+int RunServer(const string& address)
+{
+    // A number is a TCP port; anything else is the path of a Unix domain socket.
+    const Map& map = Map::Classic();
+    unique_ptr<ShardedGameServer> server;
+    if (address.find_first_not_of("0123456789") == string::npos)
+        server.reset(new ShardedGameServer(map, static_cast<uint16_t>(stoi(address))));
+    else
+        server.reset(new ShardedGameServer(map, address));
+
+    cout << "Serving on " << (server->GetPort() != 0 ? "port " + to_string(server->GetPort()) : address)
+        << " with " << server->GetNumShards() << " threads" << endl;
+    server->Run();
+    return 0;
+}
+#endif
+
 int main(int argc, const char* argv[])
 {
+    if (argc > 2 && string(argv[1]) == "simulate")
+        return RunSimulation(stoll(argv[2]));
+    if (argc > 2 && string(argv[1]) == "benchmark-parse")
+        return RunParseBenchmark(stoll(argv[2]));
+#ifdef __linux__
+    if (argc > 2 && string(argv[1]) == "serve")
+        return RunServer(argv[2]);
+#endif
+    if (argc > 1 && string(argv[1]) == "script")
+        return RunScript();
+
     return (argc > 1) ? RunTests() : RunGame();
 }
@@ -1,39 +1,317 @@
 #include "Map.h"
 
-Map::Map()
-{
-    m_connections[1] = { 2, 5, 8 };
-    m_connections[2] = { 1, 3, 10 };
-    m_connections[3] = { 2, 4, 12 };
-    m_connections[4] = { 3, 5, 14 };
-    m_connections[5] = { 1, 4, 6 };
-    m_connections[6] = { 5, 7, 15 };
-    m_connections[7] = { 6, 8, 17 };
-    m_connections[8] = { 1, 7, 9 };
-    m_connections[9] = { 8, 10, 18 };
-    m_connections[10] = { 2, 9, 11 };
-    m_connections[11] = { 10, 12, 19 };
-    m_connections[12] = { 3, 11, 13 };
-    m_connections[13] = { 12, 14, 20 };
-    m_connections[14] = { 4, 13, 15 };
-    m_connections[15] = { 6, 14, 16 };
-    m_connections[16] = { 15, 17, 20 };
-    m_connections[17] = { 7, 16, 18 };
-    m_connections[18] = { 9, 17, 19 };
-    m_connections[19] = { 11, 18, 20 };
-    m_connections[20] = { 13, 16, 19 };
+#include <algorithm>
+#include <istream>
+
+namespace
+{
+    // Distance table entry for rooms with no path between them.
+    const uint8_t Unreachable = 0xff;
+
+    // Room numbers are one-based. We leave the zero row empty.
+    const ints3 Dodecahedron[21] =
+    {
+        {},
+        { 2, 5, 8 },
+        { 1, 3, 10 },
+        { 2, 4, 12 },
+        { 3, 5, 14 },
+        { 1, 4, 6 },
+        { 5, 7, 15 },
+        { 6, 8, 17 },
+        { 1, 7, 9 },
+        { 8, 10, 18 },
+        { 2, 9, 11 },
+        { 10, 12, 19 },
+        { 3, 11, 13 },
+        { 12, 14, 20 },
+        { 4, 13, 15 },
+        { 6, 14, 16 },
+        { 15, 17, 20 },
+        { 7, 16, 18 },
+        { 9, 17, 19 },
+        { 11, 18, 20 },
+        { 13, 16, 19 }
+    };
+
+    vector<ints2> DodecahedronTunnels()
+    {
+        vector<ints2> tunnels;
+        for (int room = 1; room <= 20; ++room)
+        {
+            for (int other : Dodecahedron[room])
+            {
+                if (room < other)
+                    tunnels.push_back({ room, other });
+            }
+        }
+        return tunnels;
+    }
+}
+
+const int Map::MaxMaskRooms;
+const int Map::MaxDistanceTableRooms;
+const int Map::NoPath;
+
+RoomList::RoomList(const int* begin, const int* end)
+    : m_begin(begin)
+    , m_end(end)
+{
+}
+
+const int* RoomList::begin() const
+{
+    return m_begin;
+}
+
+const int* RoomList::end() const
+{
+    return m_end;
+}
+
+int RoomList::size() const
+{
+    return static_cast<int>(m_end - m_begin);
+}
+
+int RoomList::operator[](int index) const
+{
+    return m_begin[index];
+}
+
+roommask Map::RoomMask(int room)
+{
+    return roommask(1) << room;
+}
+
+Map Map::Load(istream& in, bool withDistanceTable)
+{
+    int numRooms;
+    if (!(in >> numRooms) || numRooms < 1)
+        throw MapFormatException();
+
+    vector<ints2> tunnels;
+    ints2 tunnel;
+    while (in >> tunnel[0])
+    {
+        if (!(in >> tunnel[1]))
+            throw MapFormatException();
+        tunnels.push_back(tunnel);
+    }
+    if (!in.eof())
+        throw MapFormatException();
+
+    return Map(numRooms, tunnels, withDistanceTable);
+}
+
+const Map& Map::Classic()
+{
+    static const Map classic;
+    return classic;
+}
+
+Map::Map(bool withDistanceTable)
+    : Map(20, DodecahedronTunnels(), withDistanceTable)
+{
+}
+
+Map::Map(int numRooms, const vector<ints2>& tunnels, bool withDistanceTable)
+    : m_numRooms(numRooms)
+    , m_offsets(numRooms + 2, 0)
+{
+    vector<ints2> directed;
+    directed.reserve(2 * tunnels.size());
+    for (const ints2& tunnel : tunnels)
+    {
+        ValidateRoom(tunnel[0]);
+        ValidateRoom(tunnel[1]);
+        if (tunnel[0] == tunnel[1])
+            throw MapFormatException();
+        directed.push_back({ tunnel[0], tunnel[1] });
+        directed.push_back({ tunnel[1], tunnel[0] });
+    }
+    sort(directed.begin(), directed.end());
+    directed.erase(unique(directed.begin(), directed.end()), directed.end());
+
+    m_tunnels.reserve(directed.size());
+    for (const ints2& tunnel : directed)
+    {
+        m_offsets[tunnel[0] + 1]++;
+        m_tunnels.push_back(tunnel[1]);
+    }
+    for (int room = 1; room <= numRooms + 1; ++room)
+        m_offsets[room] += m_offsets[room - 1];
+
+    if (numRooms <= MaxMaskRooms)
+    {
+        m_connectedMasks.assign(numRooms + 1, 0);
+        for (int room = 1; room <= numRooms; ++room)
+        {
+            for (int other : GetTunnels(room))
+                m_connectedMasks[room] |= RoomMask(other);
+        }
+    }
+
+    if (withDistanceTable && numRooms <= MaxDistanceTableRooms)
+        BuildDistanceTable();
+}
+
+void Map::BuildDistanceTable()
+{
+    // Breadth-first search from every room. Distances can't reach Unreachable, since a
+    // path visits each of at most 255 rooms once.
+    m_distances.assign((m_numRooms + 1) * (m_numRooms + 1), Unreachable);
+    m_nextHops.assign((m_numRooms + 1) * (m_numRooms + 1), 0);
+
+    intvec queue(m_numRooms);
+    for (int from = 1; from <= m_numRooms; ++from)
+    {
+        int head = 0;
+        int tail = 0;
+        queue[tail++] = from;
+        m_distances[TableIndex(from, from)] = 0;
+        while (head < tail)
+        {
+            int room = queue[head++];
+            uint8_t distance = m_distances[TableIndex(from, room)];
+            for (int other : GetTunnels(room))
+            {
+                if (m_distances[TableIndex(from, other)] == Unreachable)
+                {
+                    m_distances[TableIndex(from, other)] = distance + 1;
+                    queue[tail++] = other;
+                }
+            }
+        }
+    }
+
+    // Tunnels are two-way, so distances are symmetric: the next hop from a room is the
+    // lowest-numbered neighbour one step closer to the destination.
+    for (int from = 1; from <= m_numRooms; ++from)
+    {
+        for (int to = 1; to <= m_numRooms; ++to)
+        {
+            uint8_t distance = m_distances[TableIndex(from, to)];
+            int nextHop = from;
+            if (distance != Unreachable && distance > 0)
+            {
+                for (int other : GetTunnels(from))
+                {
+                    if (m_distances[TableIndex(other, to)] == distance - 1)
+                    {
+                        nextHop = other;
+                        break;
+                    }
+                }
+            }
+            m_nextHops[TableIndex(from, to)] = static_cast<uint8_t>(nextHop);
+        }
+    }
+}
+
+int Map::GetNumRooms() const
+{
+    return m_numRooms;
+}
+
+bool Map::IsRoom(int room) const
+{
+    return room >= 1 && room <= m_numRooms;
+}
+
+RoomList Map::GetTunnels(int room) const
+{
+    ValidateRoom(room);
+
+    const int* tunnels = m_tunnels.data();
+    return RoomList(tunnels + m_offsets[room], tunnels + m_offsets[room + 1]);
 }
 
 ints3 Map::GetConnectedRooms(int room) const
 {
-    if (room < 1 || room > 20)
-        throw NoSuchRoomException();
+    RoomList tunnels = GetTunnels(room);
+    if (tunnels.size() != 3)
+        throw TunnelCountException();
 
-    return m_connections[room];
+    return { tunnels[0], tunnels[1], tunnels[2] };
+}
+
+bool Map::HasConnectedMasks() const
+{
+    return !m_connectedMasks.empty();
+}
+
+roommask Map::GetConnectedMask(int room) const
+{
+    ValidateRoom(room);
+    if (!HasConnectedMasks())
+        throw TooManyRoomsException();
+
+    return m_connectedMasks[room];
 }
 
 bool Map::AreConnected(int room1, int room2) const
 {
-    ints3 connectedRooms = m_connections[room1];
-    return find(connectedRooms.begin(), connectedRooms.end(), room2) != connectedRooms.end();
+    if (HasConnectedMasks())
+        return (m_connectedMasks[room1] & RoomMask(room2)) != 0;
+
+    const int* tunnels = m_tunnels.data();
+    return binary_search(tunnels + m_offsets[room1], tunnels + m_offsets[room1 + 1], room2);
+}
+
+bool Map::HasDistanceTable() const
+{
+    return !m_distances.empty();
+}
+
+int Map::Distance(int from, int to) const
+{
+    ValidateDistanceQuery(from, to);
+
+    uint8_t distance = m_distances[TableIndex(from, to)];
+    return (distance == Unreachable) ? NoPath : distance;
+}
+
+int Map::NextHop(int from, int to) const
+{
+    ValidateDistanceQuery(from, to);
+
+    return m_nextHops[TableIndex(from, to)];
+}
+
+intvec Map::Path(int from, int to) const
+{
+    ValidateDistanceQuery(from, to);
+
+    intvec path;
+    if (m_distances[TableIndex(from, to)] == Unreachable)
+        return path;
+
+    for (int room = from; room != to; )
+    {
+        room = m_nextHops[TableIndex(room, to)];
+        path.push_back(room);
+    }
+    return path;
+}
+
+void Map::ValidateDistanceQuery(int from, int to) const
+{
+    ValidateRoom(from);
+    ValidateRoom(to);
+    if (m_numRooms > MaxDistanceTableRooms)
+        throw TooManyRoomsException();
+    if (!HasDistanceTable())
+        throw NoDistanceTableException();
+}
+
+int Map::TableIndex(int from, int to) const
+{
+    return from * (m_numRooms + 1) + to;
+}
+
+void Map::ValidateRoom(int room) const
+{
+    if (!IsRoom(room))
+        throw NoSuchRoomException();
 }
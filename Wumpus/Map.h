@@ -1,17 +1,90 @@
 #pragma once
 
+#include <iosfwd>
 #include "Exceptions.h"
 #include "stdtypes.h"
 
+// Read-only view of the rooms a room's tunnels lead to, in ascending order.
+class RoomList
+{
+public:
+    RoomList(const int* begin, const int* end);
+
+    const int* begin() const;
+    const int* end() const;
+    int size() const;
+    int operator[](int index) const;
+
+private:
+    const int* m_begin;
+    const int* m_end;
+};
+
 class Map
 {
 public:
-    Map();
+    // Caves with more rooms than this have no connected masks.
+    static const int MaxMaskRooms = 31;
+    // Caves with more rooms than this have no distance table, even if one is asked for.
+    static const int MaxDistanceTableRooms = 255;
+    // Distance between rooms with no path between them.
+    static const int NoPath = -1;
+
+    static roommask RoomMask(int room);
 
+    // Reads a cave as a room count followed by pairs of room numbers, one pair per
+    // two-way tunnel, all whitespace-separated.
+    static Map Load(istream& in, bool withDistanceTable = false);
+
+    // The classic dodecahedron, built on first use and shared by everything that doesn't
+    // need its own cave. Maps are immutable, so it is safe to share across threads.
+    static const Map& Classic();
+
+    // Builds a new copy of the classic dodecahedron.
+    explicit Map(bool withDistanceTable = false);
+    // The distance tables take a breadth-first search per room and two bytes per pair of
+    // rooms, and every copy of the Map carries them, so only Maps that answer distance
+    // queries should ask for them.
+    Map(int numRooms, const vector<ints2>& tunnels, bool withDistanceTable = false);
+
+    int GetNumRooms() const;
+    bool IsRoom(int room) const;
+    RoomList GetTunnels(int room) const;
+
+    // Only for rooms with exactly three tunnels, as in the dodecahedron.
     ints3 GetConnectedRooms(int room) const;
+
+    // Masks are only built for caves of up to MaxMaskRooms rooms.
+    bool HasConnectedMasks() const;
+    roommask GetConnectedMask(int room) const;
     bool AreConnected(int room1, int room2) const;
 
+    // Shortest-path queries, answered from tables built with the Map. Only for Maps built
+    // with withDistanceTable set and up to MaxDistanceTableRooms rooms.
+    bool HasDistanceTable() const;
+    int Distance(int from, int to) const;
+    // The first room on a shortest path from one room to another, or from itself if they
+    // are the same room or there is no path.
+    int NextHop(int from, int to) const;
+    // The rooms along a shortest path, excluding from and including to. Empty if there is
+    // no path.
+    intvec Path(int from, int to) const;
+
+private:
+    void ValidateRoom(int room) const;
+    void ValidateDistanceQuery(int from, int to) const;
+    void BuildDistanceTable();
+    int TableIndex(int from, int to) const;
+
 private:
-    // Room numbers are one-based. We leave the zero row empty.
-    array<ints3, 21> m_connections;
+    int m_numRooms;
+    // Compressed sparse rows: the tunnels from room r are m_tunnels[m_offsets[r]] up to
+    // m_tunnels[m_offsets[r + 1]]. Room numbers are one-based, so row zero is empty.
+    intvec m_offsets;
+    intvec m_tunnels;
+    // Bit n of row r is set if room n connects to room r. Empty for large caves.
+    vector<roommask> m_connectedMasks;
+    // (rooms + 1) x (rooms + 1) tables indexed by TableIndex. Empty for large caves.
+    vector<uint8_t> m_distances;
+    vector<uint8_t> m_nextHops;
 };
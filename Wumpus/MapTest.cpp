@@ -3,10 +3,18 @@
 #include <algorithm>
 #include "Map.h"
 #include <set>
+#include <sstream>
 
 TEST_CASE("Map")
 {
-    Map map;
+    Map map(true);
+
+    SECTION("Classic map is shared")
+    {
+        REQUIRE(&Map::Classic() == &Map::Classic());
+        for (int room = 1; room <= 20; ++room)
+            REQUIRE(Map::Classic().GetConnectedRooms(room) == map.GetConnectedRooms(room));
+    }
 
     SECTION("Room 2")
     {
@@ -57,4 +65,142 @@ TEST_CASE("Map")
         REQUIRE(map.AreConnected(2, 10));
         REQUIRE(!map.AreConnected(2, 5));
     }
+
+    SECTION("Connected mask matches connected rooms")
+    {
+        for (int room = 1; room <= 20; ++room)
+        {
+            INFO("Room " << room);
+            auto connections = map.GetConnectedRooms(room);
+            roommask expected = Map::RoomMask(connections[0]) | Map::RoomMask(connections[1]) | Map::RoomMask(connections[2]);
+            REQUIRE(map.GetConnectedMask(room) == expected);
+        }
+    }
+
+    SECTION("Distance table is optional")
+    {
+        REQUIRE(!Map().HasDistanceTable());
+        REQUIRE(!Map::Classic().HasDistanceTable());
+        REQUIRE_THROWS_AS(Map().Distance(1, 2), NoDistanceTableException);
+    }
+
+    SECTION("Distances")
+    {
+        REQUIRE(map.HasDistanceTable());
+        REQUIRE(map.Distance(2, 2) == 0);
+        REQUIRE(map.Distance(2, 10) == 1);
+        REQUIRE(map.Distance(2, 11) == 2);
+        REQUIRE(map.Distance(11, 2) == 2);
+        REQUIRE_THROWS_AS(map.Distance(0, 2), NoSuchRoomException);
+    }
+
+    SECTION("Every room within five tunnels")
+    {
+        for (int from = 1; from <= 20; ++from)
+        {
+            for (int to = 1; to <= 20; ++to)
+            {
+                INFO("From " << from << " to " << to);
+                REQUIRE(map.Distance(from, to) <= 5);
+                REQUIRE(map.Distance(from, to) == map.Distance(to, from));
+            }
+        }
+    }
+
+    SECTION("Shortest paths")
+    {
+        REQUIRE(map.NextHop(2, 11) == 10);
+        REQUIRE(map.NextHop(2, 2) == 2);
+        REQUIRE(map.Path(2, 11) == intvec({ 10, 11 }));
+        REQUIRE(map.Path(2, 2).empty());
+
+        for (int to = 1; to <= 20; ++to)
+        {
+            intvec path = map.Path(1, to);
+            REQUIRE(static_cast<int>(path.size()) == map.Distance(1, to));
+            int room = 1;
+            for (int next : path)
+            {
+                REQUIRE(map.AreConnected(room, next));
+                room = next;
+            }
+        }
+    }
+
+    SECTION("No connected mask for room 0 or 21")
+    {
+        REQUIRE_THROWS_AS(map.GetConnectedMask(0), NoSuchRoomException);
+        REQUIRE_THROWS_AS(map.GetConnectedMask(21), NoSuchRoomException);
+    }
+}
+
+TEST_CASE("Custom map")
+{
+    SECTION("Square")
+    {
+        Map map(4, { { 1, 2 }, { 2, 3 }, { 3, 4 }, { 4, 1 } });
+        REQUIRE(map.GetNumRooms() == 4);
+        REQUIRE(map.GetTunnels(1).size() == 2);
+        REQUIRE(map.GetTunnels(1)[0] == 2);
+        REQUIRE(map.GetTunnels(1)[1] == 4);
+        REQUIRE(map.AreConnected(4, 1));
+        REQUIRE(!map.AreConnected(1, 3));
+        REQUIRE_THROWS_AS(map.GetConnectedRooms(1), TunnelCountException);
+        REQUIRE_THROWS_AS(map.GetTunnels(5), NoSuchRoomException);
+    }
+
+    SECTION("Duplicate tunnels")
+    {
+        Map map(2, { { 1, 2 }, { 2, 1 } });
+        REQUIRE(map.GetTunnels(1).size() == 1);
+    }
+
+    SECTION("Disconnected rooms")
+    {
+        Map map(4, { { 1, 2 }, { 3, 4 } }, true);
+        REQUIRE(map.Distance(1, 3) == Map::NoPath);
+        REQUIRE(map.NextHop(1, 3) == 1);
+        REQUIRE(map.Path(1, 3).empty());
+    }
+
+    SECTION("Bad tunnels")
+    {
+        REQUIRE_THROWS_AS(Map(4, { { 1, 5 } }), NoSuchRoomException);
+        REQUIRE_THROWS_AS(Map(4, { { 2, 2 } }), MapFormatException);
+    }
+
+    SECTION("Large ring")
+    {
+        const int numRooms = 100000;
+        vector<ints2> tunnels;
+        for (int room = 1; room <= numRooms; ++room)
+            tunnels.push_back({ room, room % numRooms + 1 });
+        Map map(numRooms, tunnels, true);
+        REQUIRE(!map.HasConnectedMasks());
+        REQUIRE_THROWS_AS(map.GetConnectedMask(1), TooManyRoomsException);
+        REQUIRE(!map.HasDistanceTable());
+        REQUIRE_THROWS_AS(map.Distance(1, 2), TooManyRoomsException);
+        REQUIRE(map.AreConnected(numRooms, 1));
+        REQUIRE(map.AreConnected(5000, 5001));
+        REQUIRE(!map.AreConnected(5000, 5002));
+    }
+
+    SECTION("Load")
+    {
+        istringstream in("3\n1 2\n2 3\n");
+        Map map = Map::Load(in);
+        REQUIRE(map.GetNumRooms() == 3);
+        REQUIRE(map.AreConnected(3, 2));
+        REQUIRE(!map.AreConnected(1, 3));
+    }
+
+    SECTION("Load bad input")
+    {
+        istringstream noRooms("");
+        REQUIRE_THROWS_AS(Map::Load(noRooms), MapFormatException);
+        istringstream oddRoom("3 1 2 3");
+        REQUIRE_THROWS_AS(Map::Load(oddRoom), MapFormatException);
+        istringstream garbage("3 1 x");
+        REQUIRE_THROWS_AS(Map::Load(garbage), MapFormatException);
+    }
 }
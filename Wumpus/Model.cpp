@@ -1,44 +1,78 @@
 #include "Model.h"
 
-namespace
-{
-    void ValidateRoom(int room)
-    {
-        if (room < 1 || room > 20)
-            throw NoSuchRoomException();
-    }
+const int Model::MaxArrows;
+const int Model::MaxPathLength;
 
-    eventvec Append(const eventvec& events1, const eventvec& events2)
-    {
-        eventvec events = events1;
-        events.insert(events.end(), events2.begin(), events2.end());
-        return events;
-    }
+Model::Model(RandomSource& randomSource)
+    : Model(randomSource, Map::Classic())
+{
 }
 
-Model::Model(RandomSource& randomSource)
+Model::Model(RandomSource& randomSource, const Map& map)
     : m_randomSource(&randomSource)
+    , m_map(&map)
 {
     Init();
 }
 
+Model Model::Fork(RandomSource& randomSource) const
+{
+    // Everything but the undo stack, so forking never allocates.
+    Model fork(randomSource, *m_map);
+    fork.m_initialPlayerRoom = m_initialPlayerRoom;
+    fork.m_initialWumpusRoom = m_initialWumpusRoom;
+    fork.m_playerAlive = m_playerAlive;
+    fork.m_wumpusAlive = m_wumpusAlive;
+    fork.m_playerRoom = m_playerRoom;
+    fork.m_wumpusRoom = m_wumpusRoom;
+    fork.m_batRooms = m_batRooms;
+    fork.m_pitRooms = m_pitRooms;
+    fork.m_arrowsRemaining = m_arrowsRemaining;
+    fork.m_arrowMovesRemaining = m_arrowMovesRemaining;
+    fork.m_arrowRoom = m_arrowRoom;
+    fork.m_prevArrowRoom = m_prevArrowRoom;
+    fork.m_batMask = m_batMask;
+    fork.m_pitMask = m_pitMask;
+    return fork;
+}
+
 void Model::Init()
 {
     m_playerAlive = true;
-    m_wumpusRoom = true;
+    m_wumpusAlive = true;
     m_arrowsRemaining = MaxArrows;
     m_arrowMovesRemaining = 0;
+    m_undoStack.clear();
 }
 
 eventvec Model::RandomPlacements()
 {
-    m_initialPlayerRoom = m_randomSource->NextInt(1, 20);
-    m_wumpusRoom = m_initialWumpusRoom = m_randomSource->NextInt(1, 20);
-    m_batRooms[0] = m_randomSource->NextInt(1, 20);
-    m_batRooms[1] = m_randomSource->NextInt(1, 20);
-    m_pitRooms[0] = m_randomSource->NextInt(1, 20);
-    m_pitRooms[1] = m_randomSource->NextInt(1, 20);
-    return PlacePlayer(m_initialPlayerRoom);
+    eventvec events;
+    EventVecSink sink(events);
+    RandomPlacements(sink);
+    return events;
+}
+
+void Model::RandomPlacements(EventSink& events)
+{
+    m_undoStack.clear();
+    int rooms[6];
+    m_randomSource->NextInts(1, m_map->GetNumRooms(), rooms, 6);
+    m_initialPlayerRoom = rooms[0];
+    m_wumpusRoom = m_initialWumpusRoom = rooms[1];
+    m_batRooms = { rooms[2], rooms[3] };
+    m_pitRooms = { rooms[4], rooms[5] };
+    UpdateHazardMasks();
+    PlacePlayer(m_initialPlayerRoom, events);
+}
+
+void Model::UpdateHazardMasks()
+{
+    if (!m_map->HasConnectedMasks())
+        return;
+
+    m_batMask = Map::RoomMask(m_batRooms[0]) | Map::RoomMask(m_batRooms[1]);
+    m_pitMask = Map::RoomMask(m_pitRooms[0]) | Map::RoomMask(m_pitRooms[1]);
 }
 
 void Model::SetPlayerRoom(int room)
@@ -58,6 +92,7 @@ void Model::SetBatRooms(int room1, int room2)
     ValidateRoom(room1);
     ValidateRoom(room2);
     m_batRooms = { room1, room2 };
+    UpdateHazardMasks();
 }
 
 void Model::SetPitRooms(int room1, int room2)
@@ -65,24 +100,42 @@ void Model::SetPitRooms(int room1, int room2)
     ValidateRoom(room1);
     ValidateRoom(room2);
     m_pitRooms = { room1, room2 };
+    UpdateHazardMasks();
 }
 
 eventvec Model::MovePlayer(int room)
 {
-    ValidateMovePlayer(room);
-    return PlacePlayer(room);
+    eventvec events;
+    EventVecSink sink(events);
+    MovePlayer(room, sink);
+    return events;
+}
+
+void Model::MovePlayer(int room, EventSink& events)
+{
+    ThrowIfFailed(TryMovePlayer(room, events));
+}
+
+CommandStatus Model::TryMovePlayer(int room, EventSink& events) noexcept
+{
+    CommandStatus status = ValidateMovePlayer(room);
+    if (status == CommandStatus::Ok)
+        PlacePlayer(room, events);
+    return status;
 }
 
-void Model::ValidateMovePlayer(int room)
+CommandStatus Model::ValidateMovePlayer(int room) const
 {
     if (!m_playerAlive)
-        throw PlayerDeadException();
-    ValidateRoom(room);
-    if (!m_map.AreConnected(m_playerRoom, room))
-        throw RoomsNotConnectedException();
+        return CommandStatus::PlayerDead;
+    if (!m_map->IsRoom(room))
+        return CommandStatus::NoSuchRoom;
+    if (!m_map->AreConnected(m_playerRoom, room))
+        return CommandStatus::RoomsNotConnected;
+    return CommandStatus::Ok;
 }
 
-eventvec Model::PlacePlayer(int room)
+void Model::PlacePlayer(int room, EventSink& events)
 {
     m_playerRoom = room;
 
@@ -91,146 +144,296 @@ eventvec Model::PlacePlayer(int room)
     bool inPitRoom = (m_playerRoom == m_pitRooms[0] || m_playerRoom == m_pitRooms[1]);
 
     if (inWumpusRoom && inBatRoom)
-        return BumpedWumpusInBatRoom();
-
-    if (inWumpusRoom && inPitRoom)
-        return BumpedWumpusInPitRoom();
-
-    if (inWumpusRoom)
-        return BumpedWumpus();
-
-    if (inBatRoom)
-        return BatSnatch();
-
-    if (inPitRoom)
-        return FellInPit();
-
-    return {};
+        BumpedWumpusInBatRoom(events);
+    else if (inWumpusRoom && inPitRoom)
+        BumpedWumpusInPitRoom(events);
+    else if (inWumpusRoom)
+        BumpedWumpus(events);
+    else if (inBatRoom)
+        BatSnatch(events);
+    else if (inPitRoom)
+        FellInPit(events);
 }
 
-eventvec Model::BumpedWumpusInBatRoom()
+void Model::BumpedWumpusInBatRoom(EventSink& events)
 {
-    eventvec events = Append({ Event::BumpedWumpus }, BatSnatch());
+    events.Add(Event::BumpedWumpus);
+    BatSnatch(events);
     if (!m_playerAlive)
-        return events;
+        return;
 
-    return Append(events, MoveWumpus());
+    MoveWumpus(events);
 }
 
-eventvec Model::BumpedWumpusInPitRoom()
+void Model::BumpedWumpusInPitRoom(EventSink& events)
 {
-    eventvec events = BumpedWumpus();
+    BumpedWumpus(events);
     if (!m_playerAlive)
-        return events;
+        return;
 
-    return Append(events, FellInPit());
+    FellInPit(events);
 }
 
-eventvec Model::BumpedWumpus()
+void Model::BumpedWumpus(EventSink& events)
 {
-    return Append({ Event::BumpedWumpus }, MoveWumpus());
+    events.Add(Event::BumpedWumpus);
+    MoveWumpus(events);
 }
 
-eventvec Model::MoveWumpus()
+void Model::MoveWumpus(EventSink& events)
 {
-    ints3 connectedRooms = m_map.GetConnectedRooms(m_wumpusRoom);
-    unsigned roomIndex = static_cast<unsigned>(m_randomSource->NextInt(0, 3));
-    if (roomIndex < connectedRooms.size())
-        m_wumpusRoom = connectedRooms[roomIndex];
+    // Each tunnel, or staying put, is equally likely.
+    RoomList tunnels = m_map->GetTunnels(m_wumpusRoom);
+    int roomIndex = m_randomSource->NextInt(0, tunnels.size());
+    if (roomIndex < tunnels.size())
+        m_wumpusRoom = tunnels[roomIndex];
 
     if (m_wumpusRoom == m_playerRoom)
     {
         m_playerAlive = false;
-        return { Event::EatenByWumpus };
+        events.Add(Event::EatenByWumpus);
     }
-
-    return {};
 }
 
-eventvec Model::BatSnatch()
+void Model::BatSnatch(EventSink& events)
 {
-    return Append({ Event::BatSnatch }, PlacePlayer(m_randomSource->NextInt(1, 20)));
+    events.Add(Event::BatSnatch);
+    PlacePlayer(m_randomSource->NextInt(1, m_map->GetNumRooms()), events);
 }
 
-eventvec Model::FellInPit()
+void Model::FellInPit(EventSink& events)
 {
     m_playerAlive = false;
-    return { Event::FellInPit };
+    events.Add(Event::FellInPit);
 }
 
 void Model::PrepareArrow(int pathLength)
+{
+    ThrowIfFailed(TryPrepareArrow(pathLength));
+}
+
+CommandStatus Model::TryPrepareArrow(int pathLength) noexcept
 {
     if (m_arrowMovesRemaining > 0)
-        throw ArrowAlreadyPreparedException();
+        return CommandStatus::ArrowAlreadyPrepared;
     if (m_arrowsRemaining == 0)
-        throw OutOfArrowsException();
-    if (pathLength < 1 || pathLength > 5)
-        throw ArrowPathLengthException();
+        return CommandStatus::OutOfArrows;
+    if (pathLength < 1 || pathLength > MaxPathLength)
+        return CommandStatus::ArrowPathLength;
 
     m_arrowsRemaining--;
     m_arrowMovesRemaining = pathLength;
     m_arrowRoom = m_prevArrowRoom = m_playerRoom;
+    return CommandStatus::Ok;
 }
 
 eventvec Model::MoveArrow(int room)
 {
-    ValidateMoveArrow(room);
+    eventvec events;
+    EventVecSink sink(events);
+    MoveArrow(room, sink);
+    return events;
+}
+
+void Model::MoveArrow(int room, EventSink& events)
+{
+    ThrowIfFailed(TryMoveArrow(room, events));
+}
+
+CommandStatus Model::TryMoveArrow(int room, EventSink& events) noexcept
+{
+    CommandStatus status = ValidateMoveArrow(room);
+    if (status != CommandStatus::Ok)
+        return status;
 
     m_arrowMovesRemaining--;
     m_prevArrowRoom = m_arrowRoom;
     m_arrowRoom = room;
 
     if (m_arrowRoom == m_playerRoom)
-        return ShotSelf();
-
-    if (m_arrowRoom == m_wumpusRoom)
-        return ShotWumpus();
-
-    if (m_arrowMovesRemaining == 0)
-        return MissedWumpus();
-
-    return {};
+        ShotSelf(events);
+    else if (m_arrowRoom == m_wumpusRoom)
+        ShotWumpus(events);
+    else if (m_arrowMovesRemaining == 0)
+        MissedWumpus(events);
+    return CommandStatus::Ok;
 }
 
-void Model::ValidateMoveArrow(int room)
+CommandStatus Model::ValidateMoveArrow(int room) const
 {
     if (m_arrowMovesRemaining <= 0)
-        throw ArrowPathLengthException();
-    ValidateRoom(room);
-    if (!m_map.AreConnected(m_arrowRoom, room))
-        throw RoomsNotConnectedException();
+        return CommandStatus::ArrowPathLength;
+    if (!m_map->IsRoom(room))
+        return CommandStatus::NoSuchRoom;
+    if (!m_map->AreConnected(m_arrowRoom, room))
+        return CommandStatus::RoomsNotConnected;
     if (room == m_prevArrowRoom)
-        throw ArrowDoubleBackException();
+        return CommandStatus::ArrowDoubleBack;
+    return CommandStatus::Ok;
 }
 
-eventvec Model::ShotSelf()
+void Model::ShotSelf(EventSink& events)
 {
     m_playerAlive = false;
-    return { Event::ShotSelf };
+    events.Add(Event::ShotSelf);
 }
 
-eventvec Model::ShotWumpus()
+void Model::ShotWumpus(EventSink& events)
 {
     m_wumpusAlive = false;
-    return { Event::KilledWumpus };
+    events.Add(Event::KilledWumpus);
 }
 
-eventvec Model::MissedWumpus()
+void Model::MissedWumpus(EventSink& events)
 {
-    return Append({ Event::MissedWumpus }, MoveWumpus());
+    events.Add(Event::MissedWumpus);
+    MoveWumpus(events);
 }
 
 eventvec Model::Replay()
+{
+    eventvec events;
+    EventVecSink sink(events);
+    Replay(sink);
+    return events;
+}
+
+void Model::Replay(EventSink& events)
 {
     Init();
     m_wumpusRoom = m_initialWumpusRoom;
-    return PlacePlayer(m_initialPlayerRoom);
+    PlacePlayer(m_initialPlayerRoom, events);
 }
 
 eventvec Model::Restart()
+{
+    eventvec events;
+    EventVecSink sink(events);
+    Restart(sink);
+    return events;
+}
+
+void Model::Restart(EventSink& events)
 {
     Init();
-    return RandomPlacements();
+    RandomPlacements(events);
+}
+
+CommandStatus Model::ApplyMovePlayer(int room, EventSink& events)
+{
+    CommandStatus status = ValidateMovePlayer(room);
+    if (status == CommandStatus::Ok)
+    {
+        PushUndo();
+        PlacePlayer(room, events);
+    }
+    return status;
+}
+
+CommandStatus Model::ApplyPrepareArrow(int pathLength)
+{
+    PushUndo();
+    CommandStatus status = TryPrepareArrow(pathLength);
+    if (status != CommandStatus::Ok)
+        m_undoStack.pop_back();
+    return status;
+}
+
+CommandStatus Model::ApplyMoveArrow(int room, EventSink& events)
+{
+    CommandStatus status = ValidateMoveArrow(room);
+    if (status == CommandStatus::Ok)
+    {
+        PushUndo();
+        TryMoveArrow(room, events);
+    }
+    return status;
+}
+
+void Model::PushUndo()
+{
+    m_undoStack.push_back({ m_playerRoom, m_wumpusRoom, m_arrowRoom, m_prevArrowRoom,
+        static_cast<uint8_t>(m_arrowsRemaining), static_cast<uint8_t>(m_arrowMovesRemaining),
+        m_playerAlive, m_wumpusAlive });
+}
+
+void Model::Undo()
+{
+    if (m_undoStack.empty())
+        throw NothingToUndoException();
+
+    const UndoRecord& record = m_undoStack.back();
+    m_playerRoom = record.m_playerRoom;
+    m_wumpusRoom = record.m_wumpusRoom;
+    m_arrowRoom = record.m_arrowRoom;
+    m_prevArrowRoom = record.m_prevArrowRoom;
+    m_arrowsRemaining = record.m_arrowsRemaining;
+    m_arrowMovesRemaining = record.m_arrowMovesRemaining;
+    m_playerAlive = record.m_playerAlive;
+    m_wumpusAlive = record.m_wumpusAlive;
+    m_undoStack.pop_back();
+}
+
+int Model::GetUndoDepth() const
+{
+    return static_cast<int>(m_undoStack.size());
+}
+
+void Model::ValidateRoom(int room) const
+{
+    if (!m_map->IsRoom(room))
+        throw NoSuchRoomException();
+}
+
+void Model::Save(Snapshot& snapshot) const
+{
+    if (m_map->GetNumRooms() > Snapshot::MaxRooms)
+        throw TooManyRoomsException();
+
+    snapshot.m_magic = Snapshot::Magic;
+    snapshot.m_version = Snapshot::CurrentVersion;
+    snapshot.m_numRooms = static_cast<uint16_t>(m_map->GetNumRooms());
+    snapshot.m_flags = (m_playerAlive ? Snapshot::PlayerAlive : 0) | (m_wumpusAlive ? Snapshot::WumpusAlive : 0);
+    snapshot.m_initialPlayerRoom = static_cast<uint16_t>(m_initialPlayerRoom);
+    snapshot.m_initialWumpusRoom = static_cast<uint16_t>(m_initialWumpusRoom);
+    snapshot.m_playerRoom = static_cast<uint16_t>(m_playerRoom);
+    snapshot.m_wumpusRoom = static_cast<uint16_t>(m_wumpusRoom);
+    for (int i = 0; i < 2; ++i)
+    {
+        snapshot.m_batRooms[i] = static_cast<uint16_t>(m_batRooms[i]);
+        snapshot.m_pitRooms[i] = static_cast<uint16_t>(m_pitRooms[i]);
+    }
+    snapshot.m_arrowRoom = static_cast<uint16_t>(m_arrowRoom);
+    snapshot.m_prevArrowRoom = static_cast<uint16_t>(m_prevArrowRoom);
+    snapshot.m_arrowsRemaining = static_cast<uint8_t>(m_arrowsRemaining);
+    snapshot.m_arrowMovesRemaining = static_cast<uint8_t>(m_arrowMovesRemaining);
+}
+
+void Model::Restore(const Snapshot& snapshot)
+{
+    ValidateSnapshot(snapshot);
+
+    m_playerAlive = (snapshot.m_flags & Snapshot::PlayerAlive) != 0;
+    m_wumpusAlive = (snapshot.m_flags & Snapshot::WumpusAlive) != 0;
+    m_initialPlayerRoom = snapshot.m_initialPlayerRoom;
+    m_initialWumpusRoom = snapshot.m_initialWumpusRoom;
+    m_playerRoom = snapshot.m_playerRoom;
+    m_wumpusRoom = snapshot.m_wumpusRoom;
+    m_batRooms = { snapshot.m_batRooms[0], snapshot.m_batRooms[1] };
+    m_pitRooms = { snapshot.m_pitRooms[0], snapshot.m_pitRooms[1] };
+    m_arrowRoom = snapshot.m_arrowRoom;
+    m_prevArrowRoom = snapshot.m_prevArrowRoom;
+    m_arrowsRemaining = snapshot.m_arrowsRemaining;
+    m_arrowMovesRemaining = snapshot.m_arrowMovesRemaining;
+    m_undoStack.clear();
+    UpdateHazardMasks();
+}
+
+void Model::ValidateSnapshot(const Snapshot& snapshot) const
+{
+    snapshot.Validate(m_map->GetNumRooms());
+    if (snapshot.m_arrowsRemaining > MaxArrows || snapshot.m_arrowMovesRemaining > MaxPathLength)
+        throw SnapshotException();
 }
 
 bool Model::PlayerAlive() const
@@ -245,22 +448,28 @@ int Model::GetPlayerRoom() const
 
 ints3 Model::GetPlayerConnectedRooms() const
 {
-    return m_map.GetConnectedRooms(m_playerRoom);
+    return m_map->GetConnectedRooms(m_playerRoom);
 }
 
 bool Model::WumpusAdjacent() const
 {
-    return m_map.AreConnected(m_playerRoom, m_wumpusRoom);
+    return m_map->AreConnected(m_playerRoom, m_wumpusRoom);
 }
 
 bool Model::BatsAdjacent() const
 {
-    return m_map.AreConnected(m_playerRoom, m_batRooms[0]) || m_map.AreConnected(m_playerRoom, m_batRooms[1]);
+    if (m_map->HasConnectedMasks())
+        return (m_map->GetConnectedMask(m_playerRoom) & m_batMask) != 0;
+
+    return m_map->AreConnected(m_playerRoom, m_batRooms[0]) || m_map->AreConnected(m_playerRoom, m_batRooms[1]);
 }
 
 bool Model::PitAdjacent() const
 {
-    return m_map.AreConnected(m_playerRoom, m_pitRooms[0]) || m_map.AreConnected(m_playerRoom, m_pitRooms[1]);
+    if (m_map->HasConnectedMasks())
+        return (m_map->GetConnectedMask(m_playerRoom) & m_pitMask) != 0;
+
+    return m_map->AreConnected(m_playerRoom, m_pitRooms[0]) || m_map->AreConnected(m_playerRoom, m_pitRooms[1]);
 }
 
 bool Model::WumpusAlive() const
@@ -2,16 +2,30 @@
 
 #include "Commands.h"
 #include "Event.h"
+#include "EventSink.h"
 #include "Map.h"
 #include "PlayerState.h"
 #include "RandomSource.h"
+#include "Snapshot.h"
 
 class Model : public Commands, public PlayerState
 {
 public:
     static const int MaxArrows = 5;
+    // The most rooms one arrow can fly through.
+    static const int MaxPathLength = 5;
 
+    // Plays on Map::Classic().
     Model(RandomSource& randomSource);
+    // The map is not copied, so it must outlive the Model. Any number of Models can share
+    // one Map.
+    Model(RandomSource& randomSource, const Map& map);
+
+    // An independent copy of the game in its current state, drawing from randomSource
+    // from now on. Pass a Clone() of this Model's source to have the fork play out exactly
+    // as this Model would; randomSource must outlive the fork. The fork starts with an
+    // empty undo stack, so it can't Undo past the point it was forked from.
+    Model Fork(RandomSource& randomSource) const;
 
     void SetPlayerRoom(int room);
     void SetWumpusRoom(int room);
@@ -25,6 +39,30 @@ public:
     eventvec Replay() override;
     eventvec Restart() override;
 
+    // Allocation-free versions of the commands above, reporting events to a sink.
+    void RandomPlacements(EventSink& events);
+    void MovePlayer(int room, EventSink& events);
+    void MoveArrow(int room, EventSink& events);
+    void Replay(EventSink& events);
+    void Restart(EventSink& events);
+
+    CommandStatus TryMovePlayer(int room, EventSink& events) noexcept override;
+    CommandStatus TryPrepareArrow(int pathLength) noexcept override;
+    CommandStatus TryMoveArrow(int room, EventSink& events) noexcept override;
+
+    // Make/unmake for searches that walk a game tree in place. Each Apply runs the command
+    // as its Try version does and, if it succeeds, pushes what the command may have changed
+    // (including where the wumpus moved and where bats dropped the player) onto an undo
+    // stack. Undo pops the last command and restores the game exactly; the random source is
+    // not rewound. RandomPlacements, Replay, Restart and Restore clear the stack. The plain
+    // and Try commands and the setters don't record anything, so using them between an
+    // Apply and its Undo leaves the stack out of step with the game.
+    CommandStatus ApplyMovePlayer(int room, EventSink& events);
+    CommandStatus ApplyPrepareArrow(int pathLength);
+    CommandStatus ApplyMoveArrow(int room, EventSink& events);
+    void Undo();
+    int GetUndoDepth() const;
+
     bool PlayerAlive() const override;
     int GetPlayerRoom() const override;
     ints3 GetPlayerConnectedRooms() const override;
@@ -39,35 +77,68 @@ public:
     ints2 GetPitRooms() const;
     int GetArrowMovesRemaining() const;
 
+    // Fills in the Model's part of a snapshot, or restores it. The snapshot must come from
+    // a Model with the same Map. Save throws TooManyRoomsException if the Map has more
+    // than Snapshot::MaxRooms rooms.
+    void Save(Snapshot& snapshot) const;
+    void Restore(const Snapshot& snapshot);
+
+    // Throws SnapshotException if Restore would reject the snapshot, without restoring it.
+    void ValidateSnapshot(const Snapshot& snapshot) const;
+
+private:
+    // The state a command can change, as it was before the command.
+    struct UndoRecord
+    {
+        int m_playerRoom;
+        int m_wumpusRoom;
+        int m_arrowRoom;
+        int m_prevArrowRoom;
+        uint8_t m_arrowsRemaining;
+        uint8_t m_arrowMovesRemaining;
+        bool m_playerAlive;
+        bool m_wumpusAlive;
+    };
+
 private:
     void Init();
-    void ValidateMovePlayer(int room);
-    eventvec PlacePlayer(int room);
-    eventvec BumpedWumpusInBatRoom();
-    eventvec BumpedWumpusInPitRoom();
-    eventvec BumpedWumpus();
-    eventvec BatSnatch();
-    eventvec FellInPit();
-    void ValidateMoveArrow(int room);
-    eventvec ShotSelf();
-    eventvec ShotWumpus();
-    eventvec MissedWumpus();
-    eventvec MoveWumpus();
+    void PushUndo();
+    void UpdateHazardMasks();
+    void ValidateRoom(int room) const;
+    CommandStatus ValidateMovePlayer(int room) const;
+    void PlacePlayer(int room, EventSink& events);
+    void BumpedWumpusInBatRoom(EventSink& events);
+    void BumpedWumpusInPitRoom(EventSink& events);
+    void BumpedWumpus(EventSink& events);
+    void BatSnatch(EventSink& events);
+    void FellInPit(EventSink& events);
+    CommandStatus ValidateMoveArrow(int room) const;
+    void ShotSelf(EventSink& events);
+    void ShotWumpus(EventSink& events);
+    void MissedWumpus(EventSink& events);
+    void MoveWumpus(EventSink& events);
 
 private:
     RandomSource* m_randomSource;
-    Map m_map;
-    int m_initialPlayerRoom;
-    int m_initialWumpusRoom;
+    const Map* m_map;
+    int m_initialPlayerRoom = 0;
+    int m_initialWumpusRoom = 0;
 
     bool m_playerAlive;
     bool m_wumpusAlive;
-    int m_playerRoom;
-    int m_wumpusRoom;
-    ints2 m_batRooms;
-    ints2 m_pitRooms;
+    int m_playerRoom = 0;
+    int m_wumpusRoom = 0;
+    ints2 m_batRooms = {};
+    ints2 m_pitRooms = {};
     int m_arrowsRemaining;
     int m_arrowMovesRemaining;
-    int m_arrowRoom;
-    int m_prevArrowRoom;
+    int m_arrowRoom = 0;
+    int m_prevArrowRoom = 0;
+
+    // Bitboard views of m_batRooms and m_pitRooms, so adjacency tests are a single AND
+    // against Map::GetConnectedMask. Only kept for caves small enough to have masks.
+    roommask m_batMask = 0;
+    roommask m_pitMask = 0;
+
+    vector<UndoRecord> m_undoStack;
 };
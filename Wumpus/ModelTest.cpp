@@ -1,7 +1,19 @@
 #include "catch.hpp"
 
+#include <cstring>
 #include "Model.h"
 #include "RandomSourceStub.h"
+#include "XoshiroRandomSource.h"
+
+namespace
+{
+    bool SameState(const Snapshot& snapshot, const Model& model)
+    {
+        Snapshot current = {};
+        model.Save(current);
+        return memcmp(&snapshot, &current, sizeof(Snapshot)) == 0;
+    }
+}
 
 TEST_CASE("Model")
 {
@@ -481,6 +493,64 @@ TEST_CASE("Model")
         }
     }
 
+    SECTION("Events to sink")
+    {
+        model.SetPlayerRoom(2);
+        model.SetWumpusRoom(10);
+        model.SetBatRooms(10, 19);
+        randomSource.SetNextInts({ 9, 1 });
+        EventBuffer events;
+        model.MovePlayer(10, events);
+        REQUIRE(eventvec(events.begin(), events.end()) == eventvec({
+            Event::BumpedWumpus, Event::BatSnatch, Event::EatenByWumpus
+        }));
+        REQUIRE(!model.PlayerAlive());
+    }
+
+    SECTION("Status instead of exceptions")
+    {
+        model.SetPlayerRoom(2);
+        model.SetWumpusRoom(20);
+        EventBuffer events;
+
+        SECTION("Move player")
+        {
+            REQUIRE(model.TryMovePlayer(0, events) == CommandStatus::NoSuchRoom);
+            REQUIRE(model.TryMovePlayer(5, events) == CommandStatus::RoomsNotConnected);
+            REQUIRE(model.GetPlayerRoom() == 2);
+            REQUIRE(model.TryMovePlayer(10, events) == CommandStatus::Ok);
+            REQUIRE(model.GetPlayerRoom() == 10);
+            REQUIRE(events.Empty());
+        }
+
+        SECTION("Move dead player")
+        {
+            model.SetPitRooms(10, 19);
+            REQUIRE(model.TryMovePlayer(10, events) == CommandStatus::Ok);
+            REQUIRE(events.Back() == Event::FellInPit);
+            REQUIRE(model.TryMovePlayer(9, events) == CommandStatus::PlayerDead);
+        }
+
+        SECTION("Prepare arrow")
+        {
+            REQUIRE(model.TryPrepareArrow(6) == CommandStatus::ArrowPathLength);
+            REQUIRE(model.GetArrowsRemaining() == Model::MaxArrows);
+            REQUIRE(model.TryPrepareArrow(2) == CommandStatus::Ok);
+            REQUIRE(model.TryPrepareArrow(2) == CommandStatus::ArrowAlreadyPrepared);
+        }
+
+        SECTION("Move arrow")
+        {
+            REQUIRE(model.TryMoveArrow(10, events) == CommandStatus::ArrowPathLength);
+            model.PrepareArrow(2);
+            REQUIRE(model.TryMoveArrow(21, events) == CommandStatus::NoSuchRoom);
+            REQUIRE(model.TryMoveArrow(5, events) == CommandStatus::RoomsNotConnected);
+            REQUIRE(model.TryMoveArrow(10, events) == CommandStatus::Ok);
+            REQUIRE(model.TryMoveArrow(2, events) == CommandStatus::ArrowDoubleBack);
+            REQUIRE(model.GetArrowMovesRemaining() == 1);
+        }
+    }
+
     SECTION("Replay after bad start")
     {
         randomSource.SetNextInts({ 2, 2 });
@@ -492,4 +562,293 @@ TEST_CASE("Model")
         }));
         REQUIRE(!model.PlayerAlive());
     }
+
+    SECTION("Apply and undo")
+    {
+        randomSource.SetNextInts({ 2, 14, 5, 16, 7, 9 });
+        model.RandomPlacements();
+        Snapshot start = {};
+        model.Save(start);
+        EventBuffer events;
+
+        SECTION("Bat snatch")
+        {
+            REQUIRE(model.ApplyMovePlayer(1, events) == CommandStatus::Ok);
+            randomSource.SetNextInts({ 13 });
+            REQUIRE(model.ApplyMovePlayer(5, events) == CommandStatus::Ok);
+            REQUIRE(model.GetPlayerRoom() == 13);
+            REQUIRE(model.GetUndoDepth() == 2);
+
+            model.Undo();
+            REQUIRE(model.GetPlayerRoom() == 1);
+            model.Undo();
+            REQUIRE(SameState(start, model));
+            REQUIRE_THROWS_AS(model.Undo(), NothingToUndoException);
+        }
+
+        SECTION("Wumpus moves after a miss")
+        {
+            REQUIRE(model.ApplyPrepareArrow(1) == CommandStatus::Ok);
+            randomSource.SetNextInts({ 1 });
+            REQUIRE(model.ApplyMoveArrow(3, events) == CommandStatus::Ok);
+            REQUIRE(model.GetWumpusRoom() == 13);
+
+            model.Undo();
+            REQUIRE(model.GetWumpusRoom() == 14);
+            REQUIRE(model.GetArrowMovesRemaining() == 1);
+            model.Undo();
+            REQUIRE(SameState(start, model));
+        }
+
+        SECTION("Player killed")
+        {
+            REQUIRE(model.ApplyPrepareArrow(5) == CommandStatus::Ok);
+            for (int room : { 3, 4, 5, 1, 2 })
+                REQUIRE(model.ApplyMoveArrow(room, events) == CommandStatus::Ok);
+            REQUIRE(!model.PlayerAlive());
+
+            model.Undo();
+            REQUIRE(model.PlayerAlive());
+            while (model.GetUndoDepth() > 0)
+                model.Undo();
+            REQUIRE(SameState(start, model));
+        }
+
+        SECTION("Failed commands are not recorded")
+        {
+            REQUIRE(model.ApplyMovePlayer(12, events) == CommandStatus::RoomsNotConnected);
+            REQUIRE(model.ApplyPrepareArrow(0) == CommandStatus::ArrowPathLength);
+            REQUIRE(model.ApplyMoveArrow(1, events) == CommandStatus::ArrowPathLength);
+            REQUIRE(model.GetUndoDepth() == 0);
+        }
+
+        SECTION("Forks start with an empty stack")
+        {
+            REQUIRE(model.ApplyMovePlayer(1, events) == CommandStatus::Ok);
+            RandomSourceStub forkRandomSource;
+            Model fork = model.Fork(forkRandomSource);
+            REQUIRE(fork.GetUndoDepth() == 0);
+            REQUIRE(fork.GetPlayerRoom() == 1);
+            REQUIRE_THROWS_AS(fork.Undo(), NothingToUndoException);
+
+            REQUIRE(fork.ApplyMovePlayer(2, events) == CommandStatus::Ok);
+            fork.Undo();
+            REQUIRE(fork.GetPlayerRoom() == 1);
+            REQUIRE(model.GetUndoDepth() == 1);
+        }
+
+        SECTION("Restart clears the stack")
+        {
+            REQUIRE(model.ApplyMovePlayer(1, events) == CommandStatus::Ok);
+            randomSource.SetNextInts({ 2, 14, 5, 16, 7, 9 });
+            model.Restart();
+            REQUIRE(model.GetUndoDepth() == 0);
+        }
+
+        SECTION("Walk and unwind")
+        {
+            XoshiroRandomSource walkRandomSource(11);
+            Model walker(walkRandomSource);
+            walker.RandomPlacements();
+            vector<Snapshot> path;
+            for (int step = 0; step < 40; ++step)
+            {
+                Snapshot before = {};
+                walker.Save(before);
+                int room = walker.GetPlayerConnectedRooms()[walkRandomSource.NextInt(0, 2)];
+                CommandStatus status;
+                switch (walkRandomSource.NextInt(0, 2))
+                {
+                case 0:
+                    status = walker.ApplyPrepareArrow(walkRandomSource.NextInt(1, 5));
+                    break;
+                case 1:
+                    status = walker.ApplyMoveArrow(room, events);
+                    break;
+                default:
+                    status = walker.ApplyMovePlayer(room, events);
+                    break;
+                }
+                if (status == CommandStatus::Ok)
+                    path.push_back(before);
+            }
+            REQUIRE(walker.GetUndoDepth() == static_cast<int>(path.size()));
+
+            while (!path.empty())
+            {
+                walker.Undo();
+                REQUIRE(SameState(path.back(), walker));
+                path.pop_back();
+            }
+        }
+    }
+
+    SECTION("Fork")
+    {
+        randomSource.SetNextInts({ 2, 14, 5, 16, 7, 9, 1 });
+        model.RandomPlacements();
+        unique_ptr<RandomSource> forkRandomSource = randomSource.Clone();
+        Model fork = model.Fork(*forkRandomSource);
+
+        SECTION("Plays independently")
+        {
+            fork.MovePlayer(10);
+            REQUIRE(fork.GetPlayerRoom() == 10);
+            REQUIRE(model.GetPlayerRoom() == 2);
+        }
+
+        SECTION("Continues the same random stream")
+        {
+            model.PrepareArrow(1);
+            fork.PrepareArrow(1);
+            REQUIRE(model.MoveArrow(3) == eventvec({ Event::MissedWumpus }));
+            REQUIRE(fork.MoveArrow(3) == eventvec({ Event::MissedWumpus }));
+            REQUIRE(fork.GetWumpusRoom() == model.GetWumpusRoom());
+            REQUIRE(fork.GetWumpusRoom() == 13);
+            REQUIRE(fork.GetArrowsRemaining() == Model::MaxArrows - 1);
+        }
+    }
+
+    SECTION("Snapshot")
+    {
+        randomSource.SetNextInts({ 2, 14, 5, 16, 7, 9 });
+        model.RandomPlacements();
+        model.MovePlayer(10);
+        model.PrepareArrow(3);
+        model.MoveArrow(11);
+
+        Snapshot snapshot = {};
+        model.Save(snapshot);
+        REQUIRE(snapshot.m_magic == Snapshot::Magic);
+        REQUIRE(snapshot.m_version == Snapshot::CurrentVersion);
+
+        RandomSourceStub otherRandomSource;
+        Model other(otherRandomSource);
+
+        SECTION("Restores state")
+        {
+            other.Restore(snapshot);
+            REQUIRE(other.GetPlayerRoom() == 10);
+            REQUIRE(other.GetWumpusRoom() == 14);
+            REQUIRE(other.GetBatRooms() == ints2({ 5, 16 }));
+            REQUIRE(other.GetPitRooms() == ints2({ 7, 9 }));
+            REQUIRE(other.GetArrowsRemaining() == Model::MaxArrows - 1);
+            REQUIRE(other.GetArrowMovesRemaining() == 2);
+            REQUIRE(other.BatsAdjacent() == model.BatsAdjacent());
+            REQUIRE(other.PitAdjacent() == model.PitAdjacent());
+        }
+
+        SECTION("Arrow keeps flying")
+        {
+            other.Restore(snapshot);
+            EventBuffer events;
+            REQUIRE(other.TryMoveArrow(10, events) == CommandStatus::ArrowDoubleBack);
+            REQUIRE(other.MoveArrow(12) == model.MoveArrow(12));
+        }
+
+        SECTION("Replay uses initial placements")
+        {
+            other.Restore(snapshot);
+            other.Replay();
+            REQUIRE(other.GetPlayerRoom() == 2);
+            REQUIRE(other.GetWumpusRoom() == 14);
+        }
+
+        SECTION("Rejects other versions")
+        {
+            snapshot.m_version++;
+            REQUIRE_THROWS_AS(other.Restore(snapshot), SnapshotException);
+        }
+
+        SECTION("Rejects other maps")
+        {
+            Map square(4, { { 1, 2 }, { 2, 3 }, { 3, 4 }, { 4, 1 } });
+            Model squareModel(otherRandomSource, square);
+            REQUIRE_THROWS_AS(squareModel.Restore(snapshot), SnapshotException);
+        }
+
+        SECTION("Rejects bad rooms")
+        {
+            snapshot.m_wumpusRoom = 21;
+            REQUIRE_THROWS_AS(other.Restore(snapshot), SnapshotException);
+        }
+    }
+}
+
+TEST_CASE("Model on custom map")
+{
+    const int numRooms = 40;
+    vector<ints2> tunnels;
+    for (int room = 1; room <= numRooms; ++room)
+        tunnels.push_back({ room, room % numRooms + 1 });
+
+    Map map(numRooms, tunnels);
+    RandomSourceStub randomSource;
+    Model model(randomSource, map);
+    model.SetPlayerRoom(35);
+    model.SetWumpusRoom(1);
+
+    SECTION("Rooms beyond 20")
+    {
+        REQUIRE_THROWS_AS(model.SetPlayerRoom(41), NoSuchRoomException);
+        REQUIRE(model.MovePlayer(36).empty());
+        REQUIRE(model.GetPlayerRoom() == 36);
+        REQUIRE_THROWS_AS(model.MovePlayer(38), RoomsNotConnectedException);
+    }
+
+    SECTION("Hazards adjacent")
+    {
+        model.SetBatRooms(36, 2);
+        model.SetPitRooms(3, 34);
+        REQUIRE(model.BatsAdjacent());
+        REQUIRE(model.PitAdjacent());
+        REQUIRE(!model.WumpusAdjacent());
+    }
+
+    SECTION("Wumpus chooses among its tunnels")
+    {
+        model.SetWumpusRoom(36);
+        randomSource.SetNextInts({ 1 });
+        eventvec events = model.MovePlayer(36);
+        REQUIRE(events == eventvec({
+            Event::BumpedWumpus
+        }));
+        REQUIRE(model.GetWumpusRoom() == 37);
+    }
+}
+
+TEST_CASE("Model on large map")
+{
+    // More rooms than fit in 16 bits.
+    const int numRooms = 70000;
+    vector<ints2> tunnels;
+    for (int room = 1; room <= numRooms; ++room)
+        tunnels.push_back({ room, room % numRooms + 1 });
+
+    Map map(numRooms, tunnels);
+    RandomSourceStub randomSource;
+    Model model(randomSource, map);
+    model.SetPlayerRoom(65537);
+    model.SetWumpusRoom(1);
+
+    SECTION("Undo restores rooms beyond 65535")
+    {
+        EventBuffer events;
+        REQUIRE(model.ApplyMovePlayer(65538, events) == CommandStatus::Ok);
+        REQUIRE(model.ApplyPrepareArrow(1) == CommandStatus::Ok);
+        randomSource.SetNextInts({ 0 });
+        REQUIRE(model.ApplyMoveArrow(65539, events) == CommandStatus::Ok);
+
+        model.Undo();
+        REQUIRE(model.GetPlayerRoom() == 65538);
+        model.Undo();
+        model.Undo();
+        REQUIRE(model.GetPlayerRoom() == 65537);
+    }
+
+    SECTION("Too many rooms to save")
+    {
+        Snapshot snapshot = {};
+        REQUIRE_THROWS_AS(model.Save(snapshot), TooManyRoomsException);
+    }
 }
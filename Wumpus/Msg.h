@@ -1,33 +1,33 @@
 #pragma once
 
-#include <string>
+#include <string_view>
 
 using namespace std;
 
 namespace Msg
 {
-    static const string BatsNearby = "BATS NEARBY!";
-    static const string BatSnatch = "ZAP--SUPER BAT SNATCH! ELSEWHEREVILLE FOR YOU!";
-    static const string BumpedWumpus = "--- OOPS, BUMPED A WUMPUS!";
-    static const string FeelDraft = "I FEEL A DRAFT";
-    static const string FellInPit = "YYYIIIIEEEE... FELL IN PIT";
-    static const string GetYouNextTime = "HEE HEE HEE - THE WUMPUS'LL GETCHA NEXT TIME!!";
-    static const string GotTheWumpus = "AHA! YOU GOT THE WUMPUS!";
-    static const string HitYourself = "OUCH! ARROW GOT YOU!";
-    static const string Huh = "HUH?";
-    static const string HuntTheWumpus = "HUNT THE WUMPUS";
-    static const string Impossible = "NOT POSSIBLE -";
-    static const string Missed = "MISSED";
-    static const string NotThatCrooked = "ARROWS AREN'T THAT CROOKED - TRY ANOTHER ROOM";
-    static const string NumberOfRooms = "N0. OF ROOMS (l-5)? ";
-    static const string OutOfArrows = "THAT WAS YOUR LAST ARROW";
-    static const string RoomNumber = "ROOM #? ";
-    static const string SameSetup = "SAME SET-UP (Y-N)? ";
-    static const string ShootOrMove = "SHOOT OR MOVE (S-M)? ";
-    static const string SmellWumpus = "I SMELL A WUMPUS!";
-    static const string TunnelsLeadTo = "TUNNELS LEAD TO ";
-    static const string WhereTo = "WHERE TO? ";
-    static const string WumpusGotYou = "TSK TSK TSK - WUMPUS GOT YOU";
-    static const string YouAreInRoom = "YOU ARE IN ROOM ";
-    static const string YouLose = "HA HA HA - YOU LOSE!";
+    inline constexpr string_view BatsNearby = "BATS NEARBY!";
+    inline constexpr string_view BatSnatch = "ZAP--SUPER BAT SNATCH! ELSEWHEREVILLE FOR YOU!";
+    inline constexpr string_view BumpedWumpus = "--- OOPS, BUMPED A WUMPUS!";
+    inline constexpr string_view FeelDraft = "I FEEL A DRAFT";
+    inline constexpr string_view FellInPit = "YYYIIIIEEEE... FELL IN PIT";
+    inline constexpr string_view GetYouNextTime = "HEE HEE HEE - THE WUMPUS'LL GETCHA NEXT TIME!!";
+    inline constexpr string_view GotTheWumpus = "AHA! YOU GOT THE WUMPUS!";
+    inline constexpr string_view HitYourself = "OUCH! ARROW GOT YOU!";
+    inline constexpr string_view Huh = "HUH?";
+    inline constexpr string_view HuntTheWumpus = "HUNT THE WUMPUS";
+    inline constexpr string_view Impossible = "NOT POSSIBLE -";
+    inline constexpr string_view Missed = "MISSED";
+    inline constexpr string_view NotThatCrooked = "ARROWS AREN'T THAT CROOKED - TRY ANOTHER ROOM";
+    inline constexpr string_view NumberOfRooms = "N0. OF ROOMS (l-5)? ";
+    inline constexpr string_view OutOfArrows = "THAT WAS YOUR LAST ARROW";
+    inline constexpr string_view RoomNumber = "ROOM #? ";
+    inline constexpr string_view SameSetup = "SAME SET-UP (Y-N)? ";
+    inline constexpr string_view ShootOrMove = "SHOOT OR MOVE (S-M)? ";
+    inline constexpr string_view SmellWumpus = "I SMELL A WUMPUS!";
+    inline constexpr string_view TunnelsLeadTo = "TUNNELS LEAD TO ";
+    inline constexpr string_view WhereTo = "WHERE TO? ";
+    inline constexpr string_view WumpusGotYou = "TSK TSK TSK - WUMPUS GOT YOU";
+    inline constexpr string_view YouAreInRoom = "YOU ARE IN ROOM ";
+    inline constexpr string_view YouLose = "HA HA HA - YOU LOSE!";
 }
@@ -0,0 +1,164 @@
+#include "MsgToken.h"
+
+#include <charconv>
+#include "Msg.h"
+#include <ostream>
+
+namespace
+{
+    // Indexed by MsgId.
+    constexpr string_view MsgTexts[] =
+    {
+        "",
+        Msg::BatsNearby,
+        Msg::BatSnatch,
+        Msg::BumpedWumpus,
+        Msg::FeelDraft,
+        Msg::FellInPit,
+        Msg::GetYouNextTime,
+        Msg::GotTheWumpus,
+        Msg::HitYourself,
+        Msg::Huh,
+        Msg::HuntTheWumpus,
+        Msg::Impossible,
+        Msg::Missed,
+        Msg::NotThatCrooked,
+        Msg::NumberOfRooms,
+        Msg::OutOfArrows,
+        Msg::RoomNumber,
+        Msg::SameSetup,
+        Msg::ShootOrMove,
+        Msg::SmellWumpus,
+        Msg::TunnelsLeadTo,
+        Msg::WhereTo,
+        Msg::WumpusGotYou,
+        Msg::YouAreInRoom,
+        Msg::YouLose
+    };
+
+    static_assert(size(MsgTexts) == static_cast<size_t>(MsgId::YouLose) + 1, "MsgTexts must have an entry for each MsgId");
+
+    // Indexed by Event.
+    constexpr MsgId EventMsgs[] =
+    {
+        MsgId::BatSnatch,
+        MsgId::BumpedWumpus,
+        MsgId::WumpusGotYou,
+        MsgId::FellInPit,
+        MsgId::GotTheWumpus,
+        MsgId::Missed,
+        MsgId::HitYourself
+    };
+
+    static_assert(size(EventMsgs) == static_cast<size_t>(Event::ShotSelf) + 1, "EventMsgs must have an entry for each Event");
+}
+
+string_view MsgText(MsgId id)
+{
+    return MsgTexts[static_cast<int>(id)];
+}
+
+MsgId EventMsg(Event event)
+{
+    return EventMsgs[static_cast<int>(event)];
+}
+
+const int MsgToken::MaxArgs;
+
+MsgToken::MsgToken(MsgId id)
+    : m_id(id)
+    , m_numArgs(0)
+    , m_args()
+    , m_text(nullptr)
+{
+}
+
+MsgToken::MsgToken(MsgId id, int arg)
+    : m_id(id)
+    , m_numArgs(1)
+    , m_args({ arg, 0, 0 })
+    , m_text(nullptr)
+{
+}
+
+MsgToken::MsgToken(MsgId id, const ints3& args)
+    : m_id(id)
+    , m_numArgs(MaxArgs)
+    , m_args(args)
+    , m_text(nullptr)
+{
+}
+
+MsgToken::MsgToken(MsgId id, int arg, const string& text)
+    : MsgToken(id, arg)
+{
+    m_text = &text;
+}
+
+MsgToken::MsgToken(MsgId id, const ints3& args, const string& text)
+    : MsgToken(id, args)
+{
+    m_text = &text;
+}
+
+MsgId MsgToken::GetId() const
+{
+    return m_id;
+}
+
+int MsgToken::GetNumArgs() const
+{
+    return m_numArgs;
+}
+
+int MsgToken::GetArg(int index) const
+{
+    return m_args[index];
+}
+
+void MsgToken::Render(ostream& out) const
+{
+    if (m_text != nullptr)
+    {
+        out << *m_text;
+        return;
+    }
+
+    out << MsgText(m_id);
+    for (int i = 0; i < m_numArgs; ++i)
+    {
+        if (i > 0)
+            out << ' ';
+        out << m_args[i];
+    }
+}
+
+void MsgToken::Render(string& out) const
+{
+    if (m_text != nullptr)
+    {
+        out += *m_text;
+        return;
+    }
+
+    out += MsgText(m_id);
+    for (int i = 0; i < m_numArgs; ++i)
+    {
+        if (i > 0)
+            out += ' ';
+        char digits[16];
+        out.append(digits, to_chars(digits, digits + sizeof(digits), m_args[i]).ptr);
+    }
+}
+
+string MsgToken::Render() const
+{
+    string out;
+    Render(out);
+    return out;
+}
+
+bool MsgToken::operator==(const MsgToken& other) const
+{
+    return m_id == other.m_id && m_numArgs == other.m_numArgs && m_args == other.m_args;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <iosfwd>
+#include <string_view>
+#include "Event.h"
+#include "stdtypes.h"
+
+// Identifies one line of Interpreter output, corresponding to the Msg constants. Blank
+// is an empty line.
+enum class MsgId
+{
+    Blank,
+    BatsNearby,
+    BatSnatch,
+    BumpedWumpus,
+    FeelDraft,
+    FellInPit,
+    GetYouNextTime,
+    GotTheWumpus,
+    HitYourself,
+    Huh,
+    HuntTheWumpus,
+    Impossible,
+    Missed,
+    NotThatCrooked,
+    NumberOfRooms,
+    OutOfArrows,
+    RoomNumber,
+    SameSetup,
+    ShootOrMove,
+    SmellWumpus,
+    TunnelsLeadTo,
+    WhereTo,
+    WumpusGotYou,
+    YouAreInRoom,
+    YouLose
+};
+
+string_view MsgText(MsgId id);
+
+// The line reporting an Event.
+MsgId EventMsg(Event event);
+
+// A line of output as a message id plus up to three integer arguments (room numbers),
+// so it can be produced without building strings. Rendering appends the arguments to
+// the message text, separated by spaces, unless the token was given the already
+// rendered text, which must outlive it.
+class MsgToken
+{
+public:
+    static const int MaxArgs = 3;
+
+    MsgToken(MsgId id);
+    MsgToken(MsgId id, int arg);
+    MsgToken(MsgId id, const ints3& args);
+    MsgToken(MsgId id, int arg, const string& text);
+    MsgToken(MsgId id, const ints3& args, const string& text);
+
+    MsgId GetId() const;
+    int GetNumArgs() const;
+    int GetArg(int index) const;
+
+    void Render(ostream& out) const;
+    void Render(string& out) const;
+    string Render() const;
+
+    // Compares ids and arguments only.
+    bool operator==(const MsgToken& other) const;
+
+private:
+    MsgId m_id;
+    int m_numArgs;
+    ints3 m_args;
+    const string* m_text;
+};
+
+using tokenvec = vector<MsgToken>;
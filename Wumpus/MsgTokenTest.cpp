@@ -0,0 +1,55 @@
+#include "catch.hpp"
+
+#include "Msg.h"
+#include "MsgToken.h"
+#include <sstream>
+
+TEST_CASE("MsgToken")
+{
+    SECTION("Text")
+    {
+        REQUIRE(MsgText(MsgId::Blank) == "");
+        REQUIRE(MsgText(MsgId::BatsNearby) == Msg::BatsNearby);
+        REQUIRE(MsgText(MsgId::YouLose) == Msg::YouLose);
+    }
+
+    SECTION("Render without arguments")
+    {
+        MsgToken token(MsgId::WhereTo);
+        REQUIRE(token.GetNumArgs() == 0);
+        REQUIRE(token.Render() == Msg::WhereTo);
+    }
+
+    SECTION("Render one argument")
+    {
+        MsgToken token(MsgId::YouAreInRoom, 12);
+        REQUIRE(token.GetArg(0) == 12);
+        REQUIRE(token.Render() == string(Msg::YouAreInRoom) + "12");
+    }
+
+    SECTION("Render three arguments to stream")
+    {
+        ostringstream out;
+        MsgToken(MsgId::TunnelsLeadTo, ints3({ 1, 3, 10 })).Render(out);
+        REQUIRE(out.str() == string(Msg::TunnelsLeadTo) + "1 3 10");
+    }
+
+    SECTION("Render pre-rendered text")
+    {
+        const string text = "PRE-RENDERED";
+        MsgToken token(MsgId::YouAreInRoom, 12, text);
+        REQUIRE(token.GetArg(0) == 12);
+        REQUIRE(token.Render() == text);
+        ostringstream out;
+        token.Render(out);
+        REQUIRE(out.str() == text);
+        REQUIRE(token == MsgToken(MsgId::YouAreInRoom, 12));
+    }
+
+    SECTION("Equality")
+    {
+        REQUIRE(MsgToken(MsgId::YouAreInRoom, 3) == MsgToken(MsgId::YouAreInRoom, 3));
+        REQUIRE(!(MsgToken(MsgId::YouAreInRoom, 3) == MsgToken(MsgId::YouAreInRoom, 4)));
+        REQUIRE(!(MsgToken(MsgId::Huh) == MsgToken(MsgId::Blank)));
+    }
+}
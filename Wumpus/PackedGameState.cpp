@@ -0,0 +1,365 @@
+#include "PackedGameState.h"
+
+#include "Model.h"
+
+namespace
+{
+    // Bit positions of the fields in the word.
+    const int PlayerRoomShift = 0;
+    const int WumpusRoomShift = 5;
+    const int BatRoom1Shift = 10;
+    const int BatRoom2Shift = 15;
+    const int PitRoom1Shift = 20;
+    const int PitRoom2Shift = 25;
+    const int ArrowRoomShift = 30;
+    const int PrevArrowRoomShift = 35;
+    const int InitialPlayerRoomShift = 40;
+    const int InitialWumpusRoomShift = 45;
+    const int ArrowsRemainingShift = 50;
+    const int ArrowMovesRemainingShift = 53;
+    const int PlayerAliveShift = 56;
+    const int WumpusAliveShift = 57;
+
+    const int CountBits = 3;
+}
+
+const int PackedGameState::RoomBits;
+const int PackedGameState::MaxRooms;
+
+PackedGameState::PackedGameState()
+    : m_bits(0)
+{
+    Init();
+}
+
+PackedGameState::PackedGameState(uint64_t bits)
+    : m_bits(bits)
+{
+}
+
+PackedGameState PackedGameState::FromSnapshot(const Snapshot& snapshot)
+{
+    if (snapshot.m_numRooms > MaxRooms)
+        throw TooManyRoomsException();
+    snapshot.Validate(snapshot.m_numRooms);
+    if (snapshot.m_arrowsRemaining > Model::MaxArrows || snapshot.m_arrowMovesRemaining > Model::MaxPathLength)
+        throw SnapshotException();
+
+    PackedGameState state(0);
+    state.Set(PlayerRoomShift, RoomBits, snapshot.m_playerRoom);
+    state.Set(WumpusRoomShift, RoomBits, snapshot.m_wumpusRoom);
+    state.Set(BatRoom1Shift, RoomBits, snapshot.m_batRooms[0]);
+    state.Set(BatRoom2Shift, RoomBits, snapshot.m_batRooms[1]);
+    state.Set(PitRoom1Shift, RoomBits, snapshot.m_pitRooms[0]);
+    state.Set(PitRoom2Shift, RoomBits, snapshot.m_pitRooms[1]);
+    state.Set(ArrowRoomShift, RoomBits, snapshot.m_arrowRoom);
+    state.Set(PrevArrowRoomShift, RoomBits, snapshot.m_prevArrowRoom);
+    state.Set(InitialPlayerRoomShift, RoomBits, snapshot.m_initialPlayerRoom);
+    state.Set(InitialWumpusRoomShift, RoomBits, snapshot.m_initialWumpusRoom);
+    state.Set(ArrowsRemainingShift, CountBits, snapshot.m_arrowsRemaining);
+    state.Set(ArrowMovesRemainingShift, CountBits, snapshot.m_arrowMovesRemaining);
+    state.Set(PlayerAliveShift, 1, (snapshot.m_flags & Snapshot::PlayerAlive) != 0);
+    state.Set(WumpusAliveShift, 1, (snapshot.m_flags & Snapshot::WumpusAlive) != 0);
+    return state;
+}
+
+uint64_t PackedGameState::GetBits() const
+{
+    return m_bits;
+}
+
+void PackedGameState::Save(Snapshot& snapshot, const Map& map) const
+{
+    snapshot.m_magic = Snapshot::Magic;
+    snapshot.m_version = Snapshot::CurrentVersion;
+    snapshot.m_numRooms = static_cast<uint16_t>(map.GetNumRooms());
+    snapshot.m_flags = (PlayerAlive() ? Snapshot::PlayerAlive : 0) | (WumpusAlive() ? Snapshot::WumpusAlive : 0);
+    snapshot.m_initialPlayerRoom = static_cast<uint16_t>(Get(InitialPlayerRoomShift, RoomBits));
+    snapshot.m_initialWumpusRoom = static_cast<uint16_t>(Get(InitialWumpusRoomShift, RoomBits));
+    snapshot.m_playerRoom = static_cast<uint16_t>(GetPlayerRoom());
+    snapshot.m_wumpusRoom = static_cast<uint16_t>(GetWumpusRoom());
+    for (int i = 0; i < 2; ++i)
+    {
+        snapshot.m_batRooms[i] = static_cast<uint16_t>(GetBatRooms()[i]);
+        snapshot.m_pitRooms[i] = static_cast<uint16_t>(GetPitRooms()[i]);
+    }
+    snapshot.m_arrowRoom = static_cast<uint16_t>(GetArrowRoom());
+    snapshot.m_prevArrowRoom = static_cast<uint16_t>(Get(PrevArrowRoomShift, RoomBits));
+    snapshot.m_arrowsRemaining = static_cast<uint8_t>(GetArrowsRemaining());
+    snapshot.m_arrowMovesRemaining = static_cast<uint8_t>(GetArrowMovesRemaining());
+}
+
+int PackedGameState::Get(int shift, int width) const
+{
+    return static_cast<int>((m_bits >> shift) & ((uint64_t(1) << width) - 1));
+}
+
+void PackedGameState::Set(int shift, int width, int value)
+{
+    uint64_t mask = ((uint64_t(1) << width) - 1) << shift;
+    m_bits = (m_bits & ~mask) | ((static_cast<uint64_t>(value) << shift) & mask);
+}
+
+void PackedGameState::SetRoom(int shift, int room)
+{
+    Set(shift, RoomBits, room);
+}
+
+void PackedGameState::Init()
+{
+    Set(PlayerAliveShift, 1, 1);
+    Set(WumpusAliveShift, 1, 1);
+    Set(ArrowsRemainingShift, CountBits, Model::MaxArrows);
+    Set(ArrowMovesRemainingShift, CountBits, 0);
+}
+
+void PackedGameState::ValidateMap(const Map& map)
+{
+    if (map.GetNumRooms() > MaxRooms)
+        throw TooManyRoomsException();
+}
+
+void PackedGameState::ValidateRoom(int room, const Map& map)
+{
+    ValidateMap(map);
+    if (!map.IsRoom(room))
+        throw NoSuchRoomException();
+}
+
+void PackedGameState::SetPlayerRoom(int room, const Map& map)
+{
+    ValidateRoom(room, map);
+    SetRoom(PlayerRoomShift, room);
+}
+
+void PackedGameState::SetWumpusRoom(int room, const Map& map)
+{
+    ValidateRoom(room, map);
+    SetRoom(WumpusRoomShift, room);
+}
+
+void PackedGameState::SetBatRooms(int room1, int room2, const Map& map)
+{
+    ValidateRoom(room1, map);
+    ValidateRoom(room2, map);
+    SetRoom(BatRoom1Shift, room1);
+    SetRoom(BatRoom2Shift, room2);
+}
+
+void PackedGameState::SetPitRooms(int room1, int room2, const Map& map)
+{
+    ValidateRoom(room1, map);
+    ValidateRoom(room2, map);
+    SetRoom(PitRoom1Shift, room1);
+    SetRoom(PitRoom2Shift, room2);
+}
+
+void PackedGameState::RandomPlacements(const Map& map, RandomSource& randomSource, EventSink& events)
+{
+    ValidateMap(map);
+    int rooms[6];
+    randomSource.NextInts(1, map.GetNumRooms(), rooms, 6);
+    SetRoom(InitialPlayerRoomShift, rooms[0]);
+    SetRoom(InitialWumpusRoomShift, rooms[1]);
+    SetRoom(WumpusRoomShift, rooms[1]);
+    SetRoom(BatRoom1Shift, rooms[2]);
+    SetRoom(BatRoom2Shift, rooms[3]);
+    SetRoom(PitRoom1Shift, rooms[4]);
+    SetRoom(PitRoom2Shift, rooms[5]);
+    PlacePlayer(rooms[0], map, randomSource, events);
+}
+
+CommandStatus PackedGameState::TryMovePlayer(int room, const Map& map, RandomSource& randomSource, EventSink& events)
+{
+    ValidateMap(map);
+    if (!PlayerAlive())
+        return CommandStatus::PlayerDead;
+    if (!map.IsRoom(room))
+        return CommandStatus::NoSuchRoom;
+    if (!map.AreConnected(GetPlayerRoom(), room))
+        return CommandStatus::RoomsNotConnected;
+
+    PlacePlayer(room, map, randomSource, events);
+    return CommandStatus::Ok;
+}
+
+void PackedGameState::PlacePlayer(int room, const Map& map, RandomSource& randomSource, EventSink& events)
+{
+    SetRoom(PlayerRoomShift, room);
+
+    ints2 batRooms = GetBatRooms();
+    ints2 pitRooms = GetPitRooms();
+    bool inWumpusRoom = (room == GetWumpusRoom());
+    bool inBatRoom = (room == batRooms[0] || room == batRooms[1]);
+    bool inPitRoom = (room == pitRooms[0] || room == pitRooms[1]);
+
+    if (inWumpusRoom)
+    {
+        events.Add(Event::BumpedWumpus);
+        if (inBatRoom)
+        {
+            BatSnatch(map, randomSource, events);
+            if (PlayerAlive())
+                MoveWumpus(map, randomSource, events);
+        }
+        else
+        {
+            MoveWumpus(map, randomSource, events);
+            if (inPitRoom && PlayerAlive())
+            {
+                Set(PlayerAliveShift, 1, 0);
+                events.Add(Event::FellInPit);
+            }
+        }
+    }
+    else if (inBatRoom)
+    {
+        BatSnatch(map, randomSource, events);
+    }
+    else if (inPitRoom)
+    {
+        Set(PlayerAliveShift, 1, 0);
+        events.Add(Event::FellInPit);
+    }
+}
+
+void PackedGameState::BatSnatch(const Map& map, RandomSource& randomSource, EventSink& events)
+{
+    events.Add(Event::BatSnatch);
+    PlacePlayer(randomSource.NextInt(1, map.GetNumRooms()), map, randomSource, events);
+}
+
+void PackedGameState::MoveWumpus(const Map& map, RandomSource& randomSource, EventSink& events)
+{
+    // As in Model: each tunnel, or staying put, is equally likely.
+    RoomList tunnels = map.GetTunnels(GetWumpusRoom());
+    int roomIndex = randomSource.NextInt(0, tunnels.size());
+    if (roomIndex < tunnels.size())
+        SetRoom(WumpusRoomShift, tunnels[roomIndex]);
+
+    if (GetWumpusRoom() == GetPlayerRoom())
+    {
+        Set(PlayerAliveShift, 1, 0);
+        events.Add(Event::EatenByWumpus);
+    }
+}
+
+CommandStatus PackedGameState::TryPrepareArrow(int pathLength)
+{
+    if (GetArrowMovesRemaining() > 0)
+        return CommandStatus::ArrowAlreadyPrepared;
+    if (GetArrowsRemaining() == 0)
+        return CommandStatus::OutOfArrows;
+    if (pathLength < 1 || pathLength > Model::MaxPathLength)
+        return CommandStatus::ArrowPathLength;
+
+    Set(ArrowsRemainingShift, CountBits, GetArrowsRemaining() - 1);
+    Set(ArrowMovesRemainingShift, CountBits, pathLength);
+    SetRoom(ArrowRoomShift, GetPlayerRoom());
+    SetRoom(PrevArrowRoomShift, GetPlayerRoom());
+    return CommandStatus::Ok;
+}
+
+CommandStatus PackedGameState::TryMoveArrow(int room, const Map& map, RandomSource& randomSource, EventSink& events)
+{
+    ValidateMap(map);
+    if (GetArrowMovesRemaining() <= 0)
+        return CommandStatus::ArrowPathLength;
+    if (!map.IsRoom(room))
+        return CommandStatus::NoSuchRoom;
+    if (!map.AreConnected(GetArrowRoom(), room))
+        return CommandStatus::RoomsNotConnected;
+    if (room == Get(PrevArrowRoomShift, RoomBits))
+        return CommandStatus::ArrowDoubleBack;
+
+    int movesRemaining = GetArrowMovesRemaining() - 1;
+    Set(ArrowMovesRemainingShift, CountBits, movesRemaining);
+    SetRoom(PrevArrowRoomShift, GetArrowRoom());
+    SetRoom(ArrowRoomShift, room);
+
+    if (room == GetPlayerRoom())
+    {
+        Set(PlayerAliveShift, 1, 0);
+        events.Add(Event::ShotSelf);
+    }
+    else if (room == GetWumpusRoom())
+    {
+        Set(WumpusAliveShift, 1, 0);
+        events.Add(Event::KilledWumpus);
+    }
+    else if (movesRemaining == 0)
+    {
+        events.Add(Event::MissedWumpus);
+        MoveWumpus(map, randomSource, events);
+    }
+    return CommandStatus::Ok;
+}
+
+void PackedGameState::Replay(const Map& map, RandomSource& randomSource, EventSink& events)
+{
+    ValidateMap(map);
+    Init();
+    SetRoom(WumpusRoomShift, Get(InitialWumpusRoomShift, RoomBits));
+    PlacePlayer(Get(InitialPlayerRoomShift, RoomBits), map, randomSource, events);
+}
+
+void PackedGameState::Restart(const Map& map, RandomSource& randomSource, EventSink& events)
+{
+    Init();
+    RandomPlacements(map, randomSource, events);
+}
+
+bool PackedGameState::PlayerAlive() const
+{
+    return Get(PlayerAliveShift, 1) != 0;
+}
+
+bool PackedGameState::WumpusAlive() const
+{
+    return Get(WumpusAliveShift, 1) != 0;
+}
+
+int PackedGameState::GetPlayerRoom() const
+{
+    return Get(PlayerRoomShift, RoomBits);
+}
+
+int PackedGameState::GetWumpusRoom() const
+{
+    return Get(WumpusRoomShift, RoomBits);
+}
+
+ints2 PackedGameState::GetBatRooms() const
+{
+    return { Get(BatRoom1Shift, RoomBits), Get(BatRoom2Shift, RoomBits) };
+}
+
+ints2 PackedGameState::GetPitRooms() const
+{
+    return { Get(PitRoom1Shift, RoomBits), Get(PitRoom2Shift, RoomBits) };
+}
+
+int PackedGameState::GetArrowsRemaining() const
+{
+    return Get(ArrowsRemainingShift, CountBits);
+}
+
+int PackedGameState::GetArrowMovesRemaining() const
+{
+    return Get(ArrowMovesRemainingShift, CountBits);
+}
+
+int PackedGameState::GetArrowRoom() const
+{
+    return Get(ArrowRoomShift, RoomBits);
+}
+
+bool PackedGameState::operator==(const PackedGameState& other) const
+{
+    return m_bits == other.m_bits;
+}
+
+bool PackedGameState::operator!=(const PackedGameState& other) const
+{
+    return m_bits != other.m_bits;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include "CommandStatus.h"
+#include "EventSink.h"
+#include "Map.h"
+#include "RandomSource.h"
+#include "Snapshot.h"
+#include "stdtypes.h"
+
+// The whole state of a game that Model keeps, packed into one 64-bit word: eight rooms
+// and the two initial rooms Replay needs at 5 bits each, the two arrow counts at 3 bits
+// each and the two alive flags. A plain value, so it is cheap to copy for search, dense
+// to store and usable directly as a hash key.
+//
+// The commands follow exactly the same rules as Model's and draw the same random numbers,
+// but the Map is passed in rather than held. Rooms must fit in 5 bits, so only maps of up
+// to MaxRooms rooms are supported.
+class PackedGameState
+{
+public:
+    static const int RoomBits = 5;
+    static const int MaxRooms = (1 << RoomBits) - 1;
+
+    // Not yet placed, both alive, with a full quiver.
+    PackedGameState();
+    explicit PackedGameState(uint64_t bits);
+
+    // From a Model's snapshot; use Model::Save to pack a Model. Throws SnapshotException
+    // for a snapshot Model::Restore would reject.
+    static PackedGameState FromSnapshot(const Snapshot& snapshot);
+
+    uint64_t GetBits() const;
+
+    // Fills in a snapshot that Model::Restore accepts for a Model on map.
+    void Save(Snapshot& snapshot, const Map& map) const;
+
+    // Like Model's setters, these accept only rooms on map.
+    void SetPlayerRoom(int room, const Map& map);
+    void SetWumpusRoom(int room, const Map& map);
+    void SetBatRooms(int room1, int room2, const Map& map);
+    void SetPitRooms(int room1, int room2, const Map& map);
+
+    void RandomPlacements(const Map& map, RandomSource& randomSource, EventSink& events);
+    CommandStatus TryMovePlayer(int room, const Map& map, RandomSource& randomSource, EventSink& events);
+    CommandStatus TryPrepareArrow(int pathLength);
+    CommandStatus TryMoveArrow(int room, const Map& map, RandomSource& randomSource, EventSink& events);
+    void Replay(const Map& map, RandomSource& randomSource, EventSink& events);
+    void Restart(const Map& map, RandomSource& randomSource, EventSink& events);
+
+    bool PlayerAlive() const;
+    bool WumpusAlive() const;
+    int GetPlayerRoom() const;
+    int GetWumpusRoom() const;
+    ints2 GetBatRooms() const;
+    ints2 GetPitRooms() const;
+    int GetArrowsRemaining() const;
+    int GetArrowMovesRemaining() const;
+    int GetArrowRoom() const;
+
+    bool operator==(const PackedGameState& other) const;
+    bool operator!=(const PackedGameState& other) const;
+
+private:
+    int Get(int shift, int width) const;
+    void Set(int shift, int width, int value);
+    void SetRoom(int shift, int room);
+    void Init();
+    static void ValidateMap(const Map& map);
+    static void ValidateRoom(int room, const Map& map);
+    void PlacePlayer(int room, const Map& map, RandomSource& randomSource, EventSink& events);
+    void BatSnatch(const Map& map, RandomSource& randomSource, EventSink& events);
+    void MoveWumpus(const Map& map, RandomSource& randomSource, EventSink& events);
+
+private:
+    uint64_t m_bits;
+};
+
+namespace std
+{
+    template<>
+    struct hash<PackedGameState>
+    {
+        size_t operator()(const PackedGameState& state) const noexcept
+        {
+            return hash<uint64_t>()(state.GetBits());
+        }
+    };
+}
@@ -0,0 +1,239 @@
+#include "catch.hpp"
+
+#include <cstring>
+#include <unordered_set>
+#include "Model.h"
+#include "PackedGameState.h"
+#include "RandomSourceStub.h"
+#include "XoshiroRandomSource.h"
+
+namespace
+{
+    bool SameSnapshot(const Model& model, const PackedGameState& state, const Map& map)
+    {
+        Snapshot modelSnapshot = {};
+        Snapshot stateSnapshot = {};
+        model.Save(modelSnapshot);
+        state.Save(stateSnapshot, map);
+        return memcmp(&modelSnapshot, &stateSnapshot, sizeof(Snapshot)) == 0;
+    }
+}
+
+TEST_CASE("PackedGameState")
+{
+    const Map& map = Map::Classic();
+    RandomSourceStub randomSource;
+    PackedGameState state;
+    eventvec events;
+    EventVecSink sink(events);
+
+    SECTION("Fits in a word")
+    {
+        REQUIRE(sizeof(PackedGameState) == sizeof(uint64_t));
+        REQUIRE(std::is_trivially_copyable<PackedGameState>::value);
+    }
+
+    SECTION("Initial state")
+    {
+        REQUIRE(state.PlayerAlive());
+        REQUIRE(state.WumpusAlive());
+        REQUIRE(state.GetArrowsRemaining() == Model::MaxArrows);
+        REQUIRE(state.GetArrowMovesRemaining() == 0);
+    }
+
+    SECTION("Random placements")
+    {
+        randomSource.SetNextInts({ 2, 11, 5, 16, 7, 9 });
+        state.RandomPlacements(map, randomSource, sink);
+        REQUIRE(events.empty());
+        REQUIRE(state.GetPlayerRoom() == 2);
+        REQUIRE(state.GetWumpusRoom() == 11);
+        REQUIRE(state.GetBatRooms() == ints2({ 5, 16 }));
+        REQUIRE(state.GetPitRooms() == ints2({ 7, 9 }));
+    }
+
+    SECTION("Commands")
+    {
+        randomSource.SetNextInts({ 2, 14, 5, 16, 7, 9 });
+        state.RandomPlacements(map, randomSource, sink);
+
+        SECTION("Move player")
+        {
+            REQUIRE(state.TryMovePlayer(10, map, randomSource, sink) == CommandStatus::Ok);
+            REQUIRE(state.GetPlayerRoom() == 10);
+            REQUIRE(state.TryMovePlayer(21, map, randomSource, sink) == CommandStatus::NoSuchRoom);
+            REQUIRE(state.TryMovePlayer(12, map, randomSource, sink) == CommandStatus::RoomsNotConnected);
+        }
+
+        SECTION("Bat snatch into pit")
+        {
+            randomSource.SetNextInts({ 7 });
+            REQUIRE(state.TryMovePlayer(1, map, randomSource, sink) == CommandStatus::Ok);
+            REQUIRE(state.TryMovePlayer(5, map, randomSource, sink) == CommandStatus::Ok);
+            REQUIRE(events == eventvec({ Event::BatSnatch, Event::FellInPit }));
+            REQUIRE(!state.PlayerAlive());
+            REQUIRE(state.TryMovePlayer(6, map, randomSource, sink) == CommandStatus::PlayerDead);
+        }
+
+        SECTION("Arrow misses")
+        {
+            REQUIRE(state.TryPrepareArrow(2) == CommandStatus::Ok);
+            REQUIRE(state.TryPrepareArrow(2) == CommandStatus::ArrowAlreadyPrepared);
+            REQUIRE(state.GetArrowsRemaining() == Model::MaxArrows - 1);
+            REQUIRE(state.TryMoveArrow(3, map, randomSource, sink) == CommandStatus::Ok);
+            REQUIRE(state.TryMoveArrow(2, map, randomSource, sink) == CommandStatus::ArrowDoubleBack);
+            REQUIRE(state.TryMoveArrow(4, map, randomSource, sink) == CommandStatus::Ok);
+            REQUIRE(state.TryMoveArrow(14, map, randomSource, sink) == CommandStatus::ArrowPathLength);
+            REQUIRE(events == eventvec({ Event::MissedWumpus }));
+        }
+
+        SECTION("Replay")
+        {
+            REQUIRE(state.TryMovePlayer(10, map, randomSource, sink) == CommandStatus::Ok);
+            REQUIRE(state.TryPrepareArrow(1) == CommandStatus::Ok);
+            state.Replay(map, randomSource, sink);
+            REQUIRE(state.GetPlayerRoom() == 2);
+            REQUIRE(state.GetWumpusRoom() == 14);
+            REQUIRE(state.GetArrowsRemaining() == Model::MaxArrows);
+            REQUIRE(state.GetArrowMovesRemaining() == 0);
+        }
+    }
+
+    SECTION("Matches Model")
+    {
+        XoshiroRandomSource commands(7);
+        for (uint64_t seed = 1; seed <= 200; ++seed)
+        {
+            XoshiroRandomSource modelRandomSource(seed);
+            XoshiroRandomSource stateRandomSource(seed);
+            Model model(modelRandomSource, map);
+            state = PackedGameState();
+            eventvec modelEvents;
+            EventVecSink modelSink(modelEvents);
+
+            events.clear();
+            model.RandomPlacements(modelSink);
+            state.RandomPlacements(map, stateRandomSource, sink);
+            REQUIRE(events == modelEvents);
+            REQUIRE(SameSnapshot(model, state, map));
+
+            for (int step = 0; step < 50; ++step)
+            {
+                events.clear();
+                modelEvents.clear();
+                CommandStatus modelStatus = CommandStatus::Ok;
+                CommandStatus stateStatus = CommandStatus::Ok;
+                switch (commands.NextInt(0, 9))
+                {
+                case 0:
+                {
+                    int pathLength = commands.NextInt(0, 6);
+                    modelStatus = model.TryPrepareArrow(pathLength);
+                    stateStatus = state.TryPrepareArrow(pathLength);
+                    break;
+                }
+                case 1:
+                case 2:
+                case 3:
+                {
+                    int room = map.GetConnectedRooms(state.GetArrowRoom() == 0 ? state.GetPlayerRoom() : state.GetArrowRoom())[commands.NextInt(0, 2)];
+                    modelStatus = model.TryMoveArrow(room, modelSink);
+                    stateStatus = state.TryMoveArrow(room, map, stateRandomSource, sink);
+                    break;
+                }
+                case 4:
+                    model.Replay(modelSink);
+                    state.Replay(map, stateRandomSource, sink);
+                    break;
+                case 5:
+                    model.Restart(modelSink);
+                    state.Restart(map, stateRandomSource, sink);
+                    break;
+                default:
+                {
+                    int room = commands.NextInt(0, 4) == 0
+                        ? commands.NextInt(1, map.GetNumRooms())
+                        : map.GetConnectedRooms(state.GetPlayerRoom())[commands.NextInt(0, 2)];
+                    modelStatus = model.TryMovePlayer(room, modelSink);
+                    stateStatus = state.TryMovePlayer(room, map, stateRandomSource, sink);
+                    break;
+                }
+                }
+                REQUIRE(stateStatus == modelStatus);
+                REQUIRE(events == modelEvents);
+                REQUIRE(SameSnapshot(model, state, map));
+            }
+        }
+    }
+
+    SECTION("Snapshot round trip")
+    {
+        randomSource.SetNextInts({ 2, 14, 5, 16, 7, 9 });
+        state.RandomPlacements(map, randomSource, sink);
+        state.TryMovePlayer(10, map, randomSource, sink);
+        state.TryPrepareArrow(3);
+        state.TryMoveArrow(11, map, randomSource, sink);
+
+        Snapshot snapshot = {};
+        state.Save(snapshot, map);
+        REQUIRE(PackedGameState::FromSnapshot(snapshot) == state);
+
+        RandomSourceStub modelRandomSource;
+        Model model(modelRandomSource, map);
+        model.Restore(snapshot);
+        REQUIRE(model.GetPlayerRoom() == 10);
+        REQUIRE(model.GetArrowMovesRemaining() == 2);
+        REQUIRE(SameSnapshot(model, state, map));
+    }
+
+    SECTION("Setters only accept rooms on the map")
+    {
+        state.SetPlayerRoom(20, map);
+        REQUIRE(state.GetPlayerRoom() == 20);
+        REQUIRE_THROWS_AS(state.SetPlayerRoom(21, map), NoSuchRoomException);
+        REQUIRE_THROWS_AS(state.SetWumpusRoom(0, map), NoSuchRoomException);
+        REQUIRE_THROWS_AS(state.SetBatRooms(1, 25, map), NoSuchRoomException);
+        REQUIRE_THROWS_AS(state.SetPitRooms(25, 1, map), NoSuchRoomException);
+    }
+
+    SECTION("Snapshot with bad counts")
+    {
+        Snapshot snapshot = {};
+        state.Save(snapshot, map);
+        REQUIRE_NOTHROW(PackedGameState::FromSnapshot(snapshot));
+
+        Snapshot tooManyArrows = snapshot;
+        tooManyArrows.m_arrowsRemaining = 9;
+        REQUIRE_THROWS_AS(PackedGameState::FromSnapshot(tooManyArrows), SnapshotException);
+
+        Snapshot pathTooLong = snapshot;
+        pathTooLong.m_arrowMovesRemaining = Model::MaxPathLength + 1;
+        REQUIRE_THROWS_AS(PackedGameState::FromSnapshot(pathTooLong), SnapshotException);
+    }
+
+    SECTION("Hashing")
+    {
+        randomSource.SetNextInts({ 2, 14, 5, 16, 7, 9 });
+        state.RandomPlacements(map, randomSource, sink);
+        PackedGameState copy = state;
+        REQUIRE(copy == state);
+        REQUIRE(hash<PackedGameState>()(copy) == hash<PackedGameState>()(state));
+
+        copy.TryMovePlayer(10, map, randomSource, sink);
+        REQUIRE(copy != state);
+
+        unordered_set<PackedGameState> seen = { state, copy };
+        REQUIRE(seen.size() == 2);
+        REQUIRE(seen.count(PackedGameState(state.GetBits())) == 1);
+    }
+
+    SECTION("Too many rooms")
+    {
+        vector<ints2> tunnels;
+        for (int room = 1; room <= 32; ++room)
+            tunnels.push_back({ room, room % 32 + 1 });
+        Map ring(32, tunnels);
+        REQUIRE_THROWS_AS(state.RandomPlacements(ring, randomSource, sink), TooManyRoomsException);
+        REQUIRE_THROWS_AS(state.SetPlayerRoom(1, ring), TooManyRoomsException);
+    }
+}
@@ -0,0 +1,17 @@
+#include "ParseInt.h"
+
+#include <charconv>
+
+bool ParseInt(string_view input, int& value) noexcept
+{
+    const char* next = input.data();
+    const char* end = next + input.size();
+    while (next != end && (*next == ' ' || (*next >= '\t' && *next <= '\r')))
+        ++next;
+
+    // from_chars takes a minus sign but not a plus.
+    if (next != end && *next == '+' && next + 1 != end && *(next + 1) != '-')
+        ++next;
+
+    return from_chars(next, end, value).ec == errc();
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <string_view>
+
+using namespace std;
+
+// Reads an integer from the start of input, accepting what stoi accepts (leading
+// whitespace, a sign, trailing junk) but reporting failure, including overflow, by
+// returning false instead of throwing. Junk input is common, so it must be cheap.
+bool ParseInt(string_view input, int& value) noexcept;
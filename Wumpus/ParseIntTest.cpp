@@ -0,0 +1,48 @@
+#include "catch.hpp"
+
+#include "ParseInt.h"
+#include "stdtypes.h"
+
+TEST_CASE("ParseInt")
+{
+    int value = 0;
+
+    SECTION("Number")
+    {
+        REQUIRE(ParseInt("12", value));
+        REQUIRE(value == 12);
+        REQUIRE(ParseInt("-3", value));
+        REQUIRE(value == -3);
+    }
+
+    SECTION("Junk")
+    {
+        REQUIRE(!ParseInt("", value));
+        REQUIRE(!ParseInt("M", value));
+        REQUIRE(!ParseInt("-", value));
+        REQUIRE(!ParseInt("99999999999", value));
+    }
+
+    SECTION("Accepts what stoi accepts")
+    {
+        const strvec inputs = { "7", "+7", " 7", "\t-7", "7 ", "7x", "007", "+", "+-7", "-+7", " ", "x7", "2147483647", "2147483648", "-2147483648", "-2147483649", "0x10", "1e3" };
+        for (const string& input : inputs)
+        {
+            int expected = 0;
+            bool stoiParsed = true;
+            try
+            {
+                expected = stoi(input);
+            }
+            catch (const exception&)
+            {
+                stoiParsed = false;
+            }
+
+            INFO(input);
+            REQUIRE(ParseInt(input, value) == stoiParsed);
+            if (stoiParsed)
+                REQUIRE(value == expected);
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#include "Policy.h"
+
+#include <algorithm>
+#include "Exceptions.h"
+
+const int Action::MaxPathLength;
+
+Action Action::Move(int room)
+{
+    Action action(false, 1);
+    action.m_path[0] = room;
+    return action;
+}
+
+Action Action::Shoot(const intvec& path)
+{
+    if (path.empty() || path.size() > MaxPathLength)
+        throw ArrowPathLengthException();
+
+    Action action(true, static_cast<int>(path.size()));
+    copy(path.begin(), path.end(), action.m_path.begin());
+    return action;
+}
+
+Action::Action(bool shoot, int pathLength)
+    : m_shoot(shoot)
+    , m_pathLength(pathLength)
+    , m_path()
+{
+}
+
+bool Action::IsShoot() const
+{
+    return m_shoot;
+}
+
+int Action::GetRoom() const
+{
+    return m_path[0];
+}
+
+int Action::GetPathLength() const
+{
+    return m_pathLength;
+}
+
+int Action::GetPathRoom(int index) const
+{
+    return m_path[index];
+}
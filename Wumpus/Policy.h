@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Model.h"
+#include "PlayerState.h"
+#include "stdtypes.h"
+
+// One player turn: either move to a connected room or shoot an arrow along a path
+// of up to Model::MaxPathLength rooms.
+class Action
+{
+public:
+    static const int MaxPathLength = Model::MaxPathLength;
+
+    static Action Move(int room);
+    static Action Shoot(const intvec& path);
+
+    bool IsShoot() const;
+    int GetRoom() const;
+    int GetPathLength() const;
+    int GetPathRoom(int index) const;
+
+private:
+    Action(bool shoot, int pathLength);
+
+    bool m_shoot;
+    int m_pathLength;
+    array<int, MaxPathLength> m_path;
+};
+
+class Policy
+{
+public:
+    virtual ~Policy() = default;
+
+    virtual Action NextAction(const PlayerState& playerState) = 0;
+};
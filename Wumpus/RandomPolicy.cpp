@@ -0,0 +1,17 @@
+#include "RandomPolicy.h"
+
+RandomPolicy::RandomPolicy(RandomSource& randomSource)
+    : m_randomSource(&randomSource)
+{
+}
+
+Action RandomPolicy::NextAction(const PlayerState& playerState)
+{
+    ints3 connected = playerState.GetPlayerConnectedRooms();
+    int room = connected[m_randomSource->NextInt(0, 2)];
+
+    if (playerState.WumpusAdjacent())
+        return Action::Shoot({ room });
+    else
+        return Action::Move(room);
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Policy.h"
+#include "RandomSource.h"
+
+// Wanders to a random connected room each turn, except that it shoots into a random
+// connected room whenever it smells the wumpus.
+class RandomPolicy : public Policy
+{
+public:
+    RandomPolicy(RandomSource& randomSource);
+
+    Action NextAction(const PlayerState& playerState) override;
+
+private:
+    RandomSource* m_randomSource;
+};
@@ -0,0 +1,32 @@
+#include "catch.hpp"
+
+#include "Model.h"
+#include "RandomPolicy.h"
+#include "RandomSourceStub.h"
+
+TEST_CASE("RandomPolicy")
+{
+    RandomSourceStub randomSource;
+    RandomPolicy policy(randomSource);
+    Model model(randomSource);
+    model.SetPlayerRoom(2);
+    model.SetWumpusRoom(20);
+
+    SECTION("Moves to a connected room")
+    {
+        randomSource.SetNextInts({ 2 });
+        Action action = policy.NextAction(model);
+        REQUIRE(!action.IsShoot());
+        REQUIRE(action.GetRoom() == 10);
+    }
+
+    SECTION("Shoots when wumpus adjacent")
+    {
+        model.SetWumpusRoom(3);
+        randomSource.SetNextInts({ 0 });
+        Action action = policy.NextAction(model);
+        REQUIRE(action.IsShoot());
+        REQUIRE(action.GetPathLength() == 1);
+        REQUIRE(action.GetPathRoom(0) == 1);
+    }
+}
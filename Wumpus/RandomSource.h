@@ -1,7 +1,25 @@
 #pragma once
 
+#include <memory>
+
+using namespace std;
+
 class RandomSource
 {
 public:
+    virtual ~RandomSource() = default;
+
     virtual int NextInt(int from, int to) = 0;
+
+    // Fills values[0..count) with draws in [from, to], as if by count calls to NextInt.
+    // Implementations override this to avoid a virtual call per draw.
+    virtual void NextInts(int from, int to, int* values, int count)
+    {
+        for (int i = 0; i < count; ++i)
+            values[i] = NextInt(from, to);
+    }
+
+    // An independent source that continues from the current position: it draws the same
+    // numbers this one would, without affecting it. Lets a game be forked mid-play.
+    virtual unique_ptr<RandomSource> Clone() const = 0;
 };
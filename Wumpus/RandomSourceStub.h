@@ -15,6 +15,15 @@ public:
         return (m_nextInt != m_nextInts.end()) ? *(m_nextInt++) : 20;
     }
 
+    // The clone gets the ints not yet drawn.
+    unique_ptr<RandomSource> Clone() const override
+    {
+        auto clone = make_unique<RandomSourceStub>();
+        intvec::const_iterator next = m_nextInt;
+        clone->SetNextInts(intvec(next, m_nextInts.cend()));
+        return clone;
+    }
+
     void SetNextInts(intvec nextInts)
     {
         m_nextInts = nextInts;
@@ -0,0 +1,41 @@
+#include "RoomText.h"
+
+#include "Msg.h"
+
+RoomText::RoomText(const Map& map)
+    : m_locations(map.GetNumRooms() + 1)
+    , m_tunnels(map.GetNumRooms() + 1)
+{
+    for (int room = 1; room <= map.GetNumRooms(); ++room)
+    {
+        m_locations[room] = string(Msg::YouAreInRoom) + to_string(room);
+
+        string& tunnels = m_tunnels[room];
+        tunnels = Msg::TunnelsLeadTo;
+        RoomList connected = map.GetTunnels(room);
+        for (int i = 0; i < connected.size(); ++i)
+        {
+            if (i > 0)
+                tunnels += ' ';
+            tunnels += to_string(connected[i]);
+        }
+    }
+}
+
+const string& RoomText::GetLocation(int room) const
+{
+    ValidateRoom(room);
+    return m_locations[room];
+}
+
+const string& RoomText::GetTunnels(int room) const
+{
+    ValidateRoom(room);
+    return m_tunnels[room];
+}
+
+void RoomText::ValidateRoom(int room) const
+{
+    if (room < 1 || room >= static_cast<int>(m_locations.size()))
+        throw NoSuchRoomException();
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Map.h"
+#include "stdtypes.h"
+
+// The "YOU ARE IN ROOM n" and "TUNNELS LEAD TO ..." lines for every room of a Map,
+// rendered once up front so the Interpreter can emit them each turn without formatting.
+class RoomText
+{
+public:
+    explicit RoomText(const Map& map);
+
+    const string& GetLocation(int room) const;
+    const string& GetTunnels(int room) const;
+
+private:
+    void ValidateRoom(int room) const;
+
+private:
+    // Room numbers are one-based. We leave the zero entries empty.
+    strvec m_locations;
+    strvec m_tunnels;
+};
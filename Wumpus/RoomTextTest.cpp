@@ -0,0 +1,33 @@
+#include "catch.hpp"
+
+#include "Msg.h"
+#include "RoomText.h"
+
+TEST_CASE("RoomText")
+{
+    Map map;
+    RoomText roomText(map);
+
+    SECTION("Location")
+    {
+        REQUIRE(roomText.GetLocation(2) == string(Msg::YouAreInRoom) + "2");
+        REQUIRE(roomText.GetLocation(20) == string(Msg::YouAreInRoom) + "20");
+    }
+
+    SECTION("Tunnels")
+    {
+        REQUIRE(roomText.GetTunnels(2) == string(Msg::TunnelsLeadTo) + "1 3 10");
+    }
+
+    SECTION("No such room")
+    {
+        REQUIRE_THROWS_AS(roomText.GetLocation(0), NoSuchRoomException);
+        REQUIRE_THROWS_AS(roomText.GetTunnels(21), NoSuchRoomException);
+    }
+
+    SECTION("Variable tunnel count")
+    {
+        RoomText squareText(Map(4, { { 1, 2 }, { 2, 3 }, { 3, 4 }, { 4, 1 } }));
+        REQUIRE(squareText.GetTunnels(3) == string(Msg::TunnelsLeadTo) + "2 4");
+    }
+}
@@ -5,22 +5,25 @@
 #include "RandomSourceStub.h"
 
 namespace {
-    void RequireOutput(const strvec& output, const strvec& msgs)
+    // Expected output lines, which may be Msg constants.
+    using msgvec = vector<string_view>;
+
+    void RequireOutput(const strvec& output, const msgvec& msgs)
     {
-        REQUIRE(output == msgs);
+        REQUIRE(output == strvec(msgs.begin(), msgs.end()));
     }
 
     void RequireNextMoveOutput(const strvec& output, int playerRoom, intvec connectedRooms)
     {
         RequireOutput(output, {
-            Msg::YouAreInRoom + to_string(playerRoom),
-            Msg::TunnelsLeadTo + to_string(connectedRooms[0]) + " " + to_string(connectedRooms[1]) + " " + to_string(connectedRooms[2]),
+            string(Msg::YouAreInRoom) + to_string(playerRoom),
+            string(Msg::TunnelsLeadTo) + to_string(connectedRooms[0]) + " " + to_string(connectedRooms[1]) + " " + to_string(connectedRooms[2]),
             "",
             Msg::ShootOrMove
         });
     }
 
-    void RequireNextMoveOutput(const strvec& output, const strvec& leadingMsgs, int playerRoom, intvec connectedRooms)
+    void RequireNextMoveOutput(const strvec& output, const msgvec& leadingMsgs, int playerRoom, intvec connectedRooms)
     {
         for (unsigned i = 0; i < leadingMsgs.size(); ++i)
             REQUIRE(output[i] == leadingMsgs[i]);
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "catch.hpp"
+
+#ifdef __linux__
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include "stdtypes.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+// Runs a server on its own thread for the life of the object. Stops and joins it on the
+// way out, even when a failed REQUIRE unwinds the test.
+template <class Server>
+class ServerThread
+{
+public:
+    explicit ServerThread(Server& server)
+        : m_server(server)
+        , m_thread([&server] { server.Run(); })
+    {
+    }
+
+    ServerThread(const ServerThread&) = delete;
+    ServerThread& operator=(const ServerThread&) = delete;
+
+    ~ServerThread()
+    {
+        m_server.Stop();
+        m_thread.join();
+    }
+
+private:
+    Server& m_server;
+    thread m_thread;
+};
+
+inline int Connect(int domain, const void* address, unsigned addressSize)
+{
+    int fd = socket(domain, SOCK_STREAM, 0);
+    REQUIRE(fd >= 0);
+
+    // Fail rather than hang if the server never answers.
+    timeval timeout = { 5, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    if (connect(fd, static_cast<const sockaddr*>(address), addressSize) != 0)
+    {
+        close(fd);
+        FAIL("connect");
+    }
+    return fd;
+}
+
+inline int ConnectTcp(uint16_t port)
+{
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    return Connect(AF_INET, &address, sizeof(address));
+}
+
+inline int ConnectUnix(const string& path)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    path.copy(address.sun_path, sizeof(address.sun_path) - 1);
+    return Connect(AF_UNIX, &address, sizeof(address));
+}
+
+// Reads until the output so far ends with a prompt. Every prompt ends with "? ".
+inline string ReadUntilPrompt(int fd)
+{
+    string output;
+    while (output.size() < 2 || output.compare(output.size() - 2, 2, "? ") != 0)
+    {
+        char buffer[256];
+        ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+        REQUIRE(received > 0);
+        output.append(buffer, received);
+    }
+    return output;
+}
+
+#endif
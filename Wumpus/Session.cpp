@@ -0,0 +1,94 @@
+#include "Session.h"
+
+Session::Session(const Map& map, const RoomText& roomText, uint64_t seed)
+    : m_randomSource(seed)
+    , m_model(m_randomSource, map)
+    , m_interp(m_model, m_model, &roomText)
+{
+}
+
+void Session::Start(string& output)
+{
+    Input(Interpreter::Randomize, output);
+}
+
+const size_t Session::MaxLineLength;
+
+bool Session::Receive(string_view data, string& output)
+{
+    while (!m_lineTooLong && !IsOver())
+    {
+        // Nothing longer than a full line and its carriage return is ever buffered.
+        size_t newline = data.find('\n');
+        size_t length = (newline == string_view::npos) ? data.size() : newline;
+        if (m_partialLine.size() + length > MaxLineLength + 1)
+        {
+            RejectLine();
+            break;
+        }
+
+        if (newline == string_view::npos)
+        {
+            m_partialLine.append(data.data(), data.size());
+            // A trailing carriage return may yet be followed by the newline.
+            bool carriageReturn = (!m_partialLine.empty() && m_partialLine.back() == '\r');
+            if (m_partialLine.size() - (carriageReturn ? 1 : 0) > MaxLineLength)
+                RejectLine();
+            break;
+        }
+
+        string_view line = data.substr(0, newline);
+        data.remove_prefix(newline + 1);
+        if (!m_partialLine.empty())
+        {
+            m_partialLine.append(line.data(), line.size());
+            line = m_partialLine;
+        }
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        if (line.size() > MaxLineLength)
+        {
+            RejectLine();
+            break;
+        }
+        Input(line, output);
+        m_partialLine.clear();
+    }
+    return !m_lineTooLong;
+}
+
+void Session::RejectLine()
+{
+    m_lineTooLong = true;
+    string().swap(m_partialLine);
+}
+
+bool Session::IsOver() const
+{
+    return m_interp.IsOver();
+}
+
+Snapshot Session::Save() const
+{
+    Snapshot snapshot = {};
+    m_model.Save(snapshot);
+    m_interp.Save(snapshot);
+    return snapshot;
+}
+
+void Session::Restore(const Snapshot& snapshot)
+{
+    // Check both parts first, so a bad snapshot can't leave the session half restored.
+    m_model.ValidateSnapshot(snapshot);
+    Interpreter::ValidateSnapshot(snapshot);
+
+    m_model.Restore(snapshot);
+    m_interp.Restore(snapshot);
+    m_partialLine.clear();
+    m_lineTooLong = false;
+}
+
+void Session::Input(string_view line, string& output)
+{
+    Interpreter::AppendOutput(m_interp.InputTokens(line), output);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string_view>
+#include "Interpreter.h"
+#include "Map.h"
+#include "Model.h"
+#include "RoomText.h"
+#include "Snapshot.h"
+#include "stdtypes.h"
+#include "XoshiroRandomSource.h"
+
+// One player's game, independent of how its input arrives: a Model and Interpreter with
+// their own RandomSource, fed raw bytes as they are received. Each complete line goes to
+// the Interpreter and the text it produces is appended to the caller's buffer, laid out
+// as Interpreter::Run would write it.
+class Session
+{
+public:
+    // Longest line accepted, not counting the line ending.
+    static const size_t MaxLineLength = 256;
+
+    // map and roomText must outlive the session, and roomText must describe map. The
+    // session plays on map without copying it.
+    Session(const Map& map, const RoomText& roomText, uint64_t seed);
+
+    // Sets up a new game, appending the opening output.
+    void Start(string& output);
+
+    // Lines may be split across calls, and may end in "\r\n" as well as "\n". Input after
+    // the end of the game is ignored. Returns false once a line runs past MaxLineLength,
+    // whether or not it has ended; the session then ignores all further input, and a
+    // server should drop the connection.
+    bool Receive(string_view data, string& output);
+
+    bool IsOver() const;
+
+    // Only whole lines of input are captured; a partial line is dropped. Restore throws
+    // SnapshotException, leaving the session unchanged, if the snapshot is invalid.
+    Snapshot Save() const;
+    void Restore(const Snapshot& snapshot);
+
+private:
+    void Input(string_view line, string& output);
+    void RejectLine();
+
+private:
+    XoshiroRandomSource m_randomSource;
+    Model m_model;
+    Interpreter m_interp;
+    string m_partialLine;
+    bool m_lineTooLong = false;
+};
@@ -0,0 +1,131 @@
+#include "catch.hpp"
+
+#include <cstring>
+#include "Exceptions.h"
+#include "Msg.h"
+#include "Session.h"
+
+namespace {
+    const char* const Script[] = { "M", "2", "S", "1", "5", "X", "M", "8", "" };
+
+    // The output a plain Model and Interpreter give for Script, with the same seed.
+    string ExpectedOutput(const Map& map, const RoomText& roomText, uint64_t seed)
+    {
+        XoshiroRandomSource randomSource(seed);
+        Model model(randomSource, map);
+        Interpreter interp(model, model, &roomText);
+
+        string output;
+        Interpreter::AppendOutput(interp.InputTokens(Interpreter::Randomize), output);
+        for (const char* line : Script)
+            Interpreter::AppendOutput(interp.InputTokens(line), output);
+        return output;
+    }
+}
+
+TEST_CASE("Session")
+{
+    Map map;
+    RoomText roomText(map);
+    Session session(map, roomText, 7);
+
+    string output;
+    session.Start(output);
+    REQUIRE(output.compare(0, Msg::HuntTheWumpus.size(), Msg::HuntTheWumpus) == 0);
+    REQUIRE(!session.IsOver());
+
+    string input;
+    for (const char* line : Script)
+        input += string(line) + "\n";
+
+    SECTION("Whole lines")
+    {
+        session.Receive(input, output);
+        REQUIRE(output == ExpectedOutput(map, roomText, 7));
+    }
+
+    SECTION("One byte at a time")
+    {
+        for (char c : input)
+            session.Receive(string_view(&c, 1), output);
+        REQUIRE(output == ExpectedOutput(map, roomText, 7));
+    }
+
+    SECTION("Carriage returns")
+    {
+        string crlfInput;
+        for (const char* line : Script)
+            crlfInput += string(line) + "\r\n";
+        session.Receive(crlfInput, output);
+        REQUIRE(output == ExpectedOutput(map, roomText, 7));
+    }
+
+    SECTION("Snapshot")
+    {
+        session.Receive("M\n", output);
+        Snapshot snapshot = session.Save();
+
+        Session restored(map, roomText, 8);
+        restored.Restore(snapshot);
+
+        string expected;
+        string restoredOutput;
+        session.Receive("X\n", expected);
+        restored.Receive("X\n", restoredOutput);
+        REQUIRE(restoredOutput == expected);
+        REQUIRE(restored.Save().m_playerRoom == snapshot.m_playerRoom);
+    }
+
+    SECTION("Bad snapshot leaves the session unchanged")
+    {
+        session.Receive("M\n", output);
+        Snapshot before = session.Save();
+        Snapshot snapshot = before;
+        snapshot.m_playerRoom = snapshot.m_playerRoom % 20 + 1;
+        snapshot.m_interpreterState = 0xff;
+
+        REQUIRE_THROWS_AS(session.Restore(snapshot), SnapshotException);
+        Snapshot after = session.Save();
+        REQUIRE(memcmp(&after, &before, sizeof(Snapshot)) == 0);
+    }
+
+    SECTION("Partial line waits for newline")
+    {
+        string before = output;
+        session.Receive("M", output);
+        REQUIRE(output == before);
+        session.Receive("\n", output);
+        REQUIRE(output == before + string(Msg::WhereTo));
+    }
+
+    SECTION("Longest line")
+    {
+        string before = output;
+        REQUIRE(session.Receive(string(Session::MaxLineLength, 'Y') + "\r\n", output));
+        REQUIRE(output == before + string(Msg::Huh) + "\n" + string(Msg::ShootOrMove));
+    }
+
+    SECTION("Line one byte too long")
+    {
+        string before = output;
+        REQUIRE(!session.Receive(string(Session::MaxLineLength + 1, 'Y') + "\n", output));
+        REQUIRE(output == before);
+    }
+
+    SECTION("Line one byte too long, split before the newline")
+    {
+        REQUIRE(session.Receive(string(Session::MaxLineLength, 'Y') + "\r", output));
+        REQUIRE(!session.Receive("Y", output));
+    }
+
+    SECTION("Line too long without a newline")
+    {
+        string before = output;
+        string chunk(Session::MaxLineLength / 2, 'M');
+        REQUIRE(session.Receive(chunk, output));
+        REQUIRE(session.Receive(chunk, output));
+        REQUIRE(!session.Receive(chunk, output));
+        REQUIRE(!session.Receive("\nM\n", output));
+        REQUIRE(output == before);
+    }
+}
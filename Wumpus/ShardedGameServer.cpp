@@ -0,0 +1,112 @@
+#include "ShardedGameServer.h"
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <pthread.h>
+#include <sched.h>
+#include "XoshiroRandomSource.h"
+
+using namespace chrono;
+
+ShardedGameServer::ShardedGameServer(const Map& map, uint16_t port, unsigned numShards)
+    : ShardedGameServer(map, make_shared<Listener>(port), numShards)
+{
+}
+
+ShardedGameServer::ShardedGameServer(const Map& map, const string& socketPath, unsigned numShards)
+    : ShardedGameServer(map, make_shared<Listener>(socketPath), numShards)
+{
+}
+
+ShardedGameServer::ShardedGameServer(const Map& map, shared_ptr<const Listener> listener, unsigned numShards)
+    : m_listener(listener)
+{
+    // As in GameFarm, each shard seeds its sessions from its own jumped-ahead stream.
+    XoshiroRandomSource seeds(system_clock::now().time_since_epoch().count());
+    numShards = max(numShards, 1u);
+    for (unsigned i = 0; i < numShards; ++i)
+    {
+        m_shards.emplace_back(new GameServer(map, m_listener, seeds));
+        seeds.Jump();
+    }
+}
+
+unsigned ShardedGameServer::GetNumShards() const
+{
+    return static_cast<unsigned>(m_shards.size());
+}
+
+uint16_t ShardedGameServer::GetPort() const
+{
+    return m_listener->GetPort();
+}
+
+namespace
+{
+    // The CPUs this process may run on, which need not be numbered from zero.
+    intvec AllowedCpus()
+    {
+        intvec cpus;
+        cpu_set_t allowed;
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0)
+        {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            {
+                if (CPU_ISSET(cpu, &allowed))
+                    cpus.push_back(cpu);
+            }
+        }
+        return cpus;
+    }
+}
+
+void ShardedGameServer::Run()
+{
+    intvec cpus = AllowedCpus();
+    mutex errorMutex;
+    exception_ptr error;
+
+    vector<thread> threads;
+    for (auto& shard : m_shards)
+    {
+        GameServer& server = *shard;
+        threads.emplace_back([this, &server, &errorMutex, &error] {
+            try
+            {
+                server.Run();
+            }
+            catch (...)
+            {
+                lock_guard<mutex> lock(errorMutex);
+                if (!error)
+                    error = current_exception();
+                Stop();
+            }
+        });
+
+        if (m_shards.size() <= cpus.size())
+        {
+            cpu_set_t cpu;
+            CPU_ZERO(&cpu);
+            CPU_SET(cpus[threads.size() - 1], &cpu);
+            pthread_setaffinity_np(threads.back().native_handle(), sizeof(cpu), &cpu);
+        }
+    }
+
+    for (thread& shardThread : threads)
+        shardThread.join();
+    if (error)
+        rethrow_exception(error);
+}
+
+void ShardedGameServer::Stop()
+{
+    for (auto& shard : m_shards)
+        shard->Stop();
+}
+
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include "GameServer.h"
+#include "Listener.h"
+#include "Map.h"
+#include "stdtypes.h"
+
+// Spreads sessions over one GameServer per core, each on its own thread, all accepting
+// from one Listener. A connection stays with the shard that accepted it, so each
+// session's Model, Interpreter and RandomSource are only ever touched by that shard's
+// thread and the shards need no locks. Linux only.
+class ShardedGameServer
+{
+public:
+    ShardedGameServer(const Map& map, uint16_t port, unsigned numShards = thread::hardware_concurrency());
+    ShardedGameServer(const Map& map, const string& socketPath, unsigned numShards = thread::hardware_concurrency());
+
+    unsigned GetNumShards() const;
+
+    // The TCP port being listened on, or 0 for a Unix domain socket.
+    uint16_t GetPort() const;
+
+    // Runs each shard on its own thread, pinned to a core where there are enough of
+    // them, until Stop is called. If a shard fails, the others are stopped and its
+    // exception is rethrown.
+    void Run();
+
+    // Makes Run return. Safe to call from another thread.
+    void Stop();
+
+private:
+    ShardedGameServer(const Map& map, shared_ptr<const Listener> listener, unsigned numShards);
+
+private:
+    shared_ptr<const Listener> m_listener;
+    vector<unique_ptr<GameServer>> m_shards;
+};
@@ -0,0 +1,64 @@
+#include "catch.hpp"
+
+#ifdef __linux__
+
+#include "Msg.h"
+#include "ServerTestHelpers.h"
+#include "ShardedGameServer.h"
+
+namespace {
+    // Reads the opening output, up to the first prompt, and checks it is a new game.
+    void RequireOpening(int fd)
+    {
+        string output = ReadUntilPrompt(fd);
+        REQUIRE(output.compare(0, Msg::HuntTheWumpus.size(), Msg::HuntTheWumpus) == 0);
+    }
+}
+
+TEST_CASE("ShardedGameServer")
+{
+    Map map;
+
+    SECTION("At least one shard")
+    {
+        ShardedGameServer server(map, 0, 0);
+        REQUIRE(server.GetNumShards() == 1);
+    }
+
+    SECTION("Serves many TCP connections")
+    {
+        ShardedGameServer server(map, 0, 4);
+        REQUIRE(server.GetPort() != 0);
+        ServerThread<ShardedGameServer> serverThread(server);
+
+        intvec fds;
+        for (int i = 0; i < 16; ++i)
+            fds.push_back(ConnectTcp(server.GetPort()));
+        for (int fd : fds)
+        {
+            RequireOpening(fd);
+            close(fd);
+        }
+    }
+
+    SECTION("Serves a Unix domain socket")
+    {
+        string path = "/tmp/wumpus-test-" + to_string(getpid()) + ".sock";
+        ShardedGameServer server(map, path, 2);
+        REQUIRE(server.GetPort() == 0);
+        ServerThread<ShardedGameServer> serverThread(server);
+
+        int fd = ConnectUnix(path);
+        RequireOpening(fd);
+        close(fd);
+    }
+
+    SECTION("Stop before Run")
+    {
+        ShardedGameServer server(map, 0, 2);
+        server.Stop();
+        server.Run();
+    }
+}
+
+#endif
@@ -5,7 +5,12 @@
 using namespace chrono;
 
 SimpleRandomSource::SimpleRandomSource()
-    : m_generator(static_cast<unsigned int>(system_clock::now().time_since_epoch().count()))
+    : SimpleRandomSource(static_cast<unsigned int>(system_clock::now().time_since_epoch().count()))
+{
+}
+
+SimpleRandomSource::SimpleRandomSource(unsigned int seed)
+    : m_generator(seed)
 {
 }
 
@@ -14,3 +19,18 @@ int SimpleRandomSource::NextInt(int from, int to)
     uniform_int_distribution<int> distribution(from, to);
     return distribution(m_generator);
 }
+
+unique_ptr<RandomSource> SimpleRandomSource::Clone() const
+{
+    return make_unique<SimpleRandomSource>(*this);
+}
+
+SimpleRandomSource::State SimpleRandomSource::GetState() const
+{
+    return m_generator;
+}
+
+void SimpleRandomSource::SetState(const State& state)
+{
+    m_generator = state;
+}
@@ -8,10 +8,18 @@ using namespace std;
 class SimpleRandomSource : public RandomSource
 {
 public:
+    using State = minstd_rand0;
+
     SimpleRandomSource();
+    explicit SimpleRandomSource(unsigned int seed);
 
     int NextInt(int from, int to) override;
+    unique_ptr<RandomSource> Clone() const override;
+
+    // The position in the stream. Restoring a saved state replays the same draws.
+    State GetState() const;
+    void SetState(const State& state);
 
 private:
-    minstd_rand0 m_generator;
+    State m_generator;
 };
@@ -19,3 +19,37 @@ TEST_CASE("SimpleRandomSource", "[.]")
         REQUIRE(counts[i] == Approx(333).epsilon(0.2));
     }
 }
+
+TEST_CASE("SimpleRandomSource seed")
+{
+    SimpleRandomSource randomSource1(42);
+    SimpleRandomSource randomSource2(42);
+    for (int i = 0; i < 100; i++)
+    {
+        REQUIRE(randomSource1.NextInt(1, 20) == randomSource2.NextInt(1, 20));
+    }
+}
+
+TEST_CASE("SimpleRandomSource state")
+{
+    SimpleRandomSource randomSource(42);
+    randomSource.NextInt(1, 20);
+
+    SECTION("Clone continues the stream")
+    {
+        unique_ptr<RandomSource> clone = randomSource.Clone();
+        for (int i = 0; i < 100; i++)
+        {
+            REQUIRE(clone->NextInt(1, 20) == randomSource.NextInt(1, 20));
+        }
+    }
+
+    SECTION("Restoring state replays draws")
+    {
+        SimpleRandomSource::State state = randomSource.GetState();
+        int first = randomSource.NextInt(1, 1000);
+        randomSource.NextInt(1, 1000);
+        randomSource.SetState(state);
+        REQUIRE(randomSource.NextInt(1, 1000) == first);
+    }
+}
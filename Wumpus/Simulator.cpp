@@ -0,0 +1,112 @@
+#include "Simulator.h"
+
+const int SimulationResults::NumOutcomes;
+const int Simulator::DefaultMaxTurns;
+
+SimulationResults::SimulationResults()
+    : m_games(0)
+    , m_turns(0)
+    , m_counts()
+{
+}
+
+void SimulationResults::Record(Outcome outcome, int turns)
+{
+    m_games++;
+    m_turns += turns;
+    m_counts[static_cast<int>(outcome)]++;
+}
+
+void SimulationResults::Merge(const SimulationResults& other)
+{
+    m_games += other.m_games;
+    m_turns += other.m_turns;
+    for (int i = 0; i < NumOutcomes; ++i)
+        m_counts[i] += other.m_counts[i];
+}
+
+long long SimulationResults::GetGames() const
+{
+    return m_games;
+}
+
+long long SimulationResults::GetTurns() const
+{
+    return m_turns;
+}
+
+long long SimulationResults::GetCount(Outcome outcome) const
+{
+    return m_counts[static_cast<int>(outcome)];
+}
+
+Simulator::Simulator(RandomSource& randomSource, Policy& policy)
+    : m_model(randomSource)
+    , m_policy(policy)
+{
+}
+
+SimulationResults Simulator::Run(long long numGames, int maxTurns)
+{
+    SimulationResults results;
+    for (long long game = 0; game < numGames; ++game)
+    {
+        int turns = 0;
+        Outcome outcome = PlayGame(maxTurns, turns);
+        results.Record(outcome, turns);
+    }
+    return results;
+}
+
+Outcome Simulator::PlayGame(int maxTurns, int& turns)
+{
+    // Same end-of-turn checks, in the same order, as Interpreter::CheckAndOutputPlayerState.
+    EventBuffer events;
+    m_model.Restart(events);
+    for (turns = 0; ; ++turns)
+    {
+        if (!m_model.WumpusAlive())
+            return Outcome::KilledWumpus;
+        if (!m_model.PlayerAlive())
+            return Death(events);
+        if (m_model.GetArrowsRemaining() == 0)
+            return Outcome::OutOfArrows;
+        if (turns == maxTurns)
+            return Outcome::TurnLimit;
+
+        events.Clear();
+        CommandStatus status = TakeTurn(m_policy.NextAction(m_model), events);
+        if (status != CommandStatus::Ok)
+            ThrowIfFailed(status);
+    }
+}
+
+CommandStatus Simulator::TakeTurn(const Action& action, EventBuffer& events)
+{
+    if (action.IsShoot())
+        return Shoot(action, events);
+    else
+        return m_model.TryMovePlayer(action.GetRoom(), events);
+}
+
+CommandStatus Simulator::Shoot(const Action& action, EventBuffer& events)
+{
+    CommandStatus status = m_model.TryPrepareArrow(action.GetPathLength());
+    for (int i = 0; i < action.GetPathLength() && status == CommandStatus::Ok && events.Empty(); ++i)
+        status = m_model.TryMoveArrow(action.GetPathRoom(i), events);
+    return status;
+}
+
+Outcome Simulator::Death(const EventBuffer& events) const
+{
+    // The fatal event is always the last one reported.
+    switch (events.Back())
+    {
+    case Event::EatenByWumpus:
+        return Outcome::EatenByWumpus;
+    case Event::FellInPit:
+        return Outcome::FellInPit;
+    default:
+        return Outcome::ShotSelf;
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "EventSink.h"
+#include "Model.h"
+#include "Policy.h"
+#include "RandomSource.h"
+
+enum class Outcome
+{
+    KilledWumpus,
+    EatenByWumpus,
+    FellInPit,
+    ShotSelf,
+    OutOfArrows,
+    TurnLimit
+};
+
+class SimulationResults
+{
+public:
+    static const int NumOutcomes = 6;
+
+    SimulationResults();
+
+    void Record(Outcome outcome, int turns);
+    void Merge(const SimulationResults& other);
+
+    long long GetGames() const;
+    long long GetTurns() const;
+    long long GetCount(Outcome outcome) const;
+
+private:
+    long long m_games;
+    long long m_turns;
+    array<long long, NumOutcomes> m_counts;
+};
+
+// Plays complete games against a Model with no text interface, letting a Policy choose
+// each turn's action. The Policy must only choose legal actions; Run throws the matching
+// GameException for one that the Model rejects.
+class Simulator
+{
+public:
+    static const int DefaultMaxTurns = 1000;
+
+    Simulator(RandomSource& randomSource, Policy& policy);
+
+    SimulationResults Run(long long numGames, int maxTurns = DefaultMaxTurns);
+
+private:
+    Outcome PlayGame(int maxTurns, int& turns);
+    CommandStatus TakeTurn(const Action& action, EventBuffer& events);
+    CommandStatus Shoot(const Action& action, EventBuffer& events);
+    Outcome Death(const EventBuffer& events) const;
+
+private:
+    Model m_model;
+    Policy& m_policy;
+};
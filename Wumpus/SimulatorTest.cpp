@@ -0,0 +1,134 @@
+#include "catch.hpp"
+
+#include "RandomSourceStub.h"
+#include "Simulator.h"
+
+class PolicyStub : public Policy
+{
+public:
+    Action NextAction(const PlayerState& playerState) override
+    {
+        return (m_nextAction != m_nextActions.end()) ? *(m_nextAction++) : Action::Move(playerState.GetPlayerConnectedRooms()[0]);
+    }
+
+    void SetNextActions(vector<Action> nextActions)
+    {
+        m_nextActions = nextActions;
+        m_nextAction = m_nextActions.begin();
+    }
+
+private:
+    vector<Action> m_nextActions = {};
+    vector<Action>::iterator m_nextAction = m_nextActions.end();
+};
+
+TEST_CASE("Action")
+{
+    SECTION("Move")
+    {
+        Action action = Action::Move(10);
+        REQUIRE(!action.IsShoot());
+        REQUIRE(action.GetRoom() == 10);
+    }
+
+    SECTION("Shoot")
+    {
+        Action action = Action::Shoot({ 10, 11, 12 });
+        REQUIRE(action.IsShoot());
+        REQUIRE(action.GetPathLength() == 3);
+        REQUIRE(action.GetPathRoom(2) == 12);
+    }
+
+    SECTION("Invalid path length")
+    {
+        REQUIRE_THROWS_AS(Action::Shoot({}), ArrowPathLengthException);
+        REQUIRE_THROWS_AS(Action::Shoot({ 1, 2, 3, 4, 5, 6 }), ArrowPathLengthException);
+    }
+}
+
+TEST_CASE("Simulator")
+{
+    RandomSourceStub randomSource;
+    PolicyStub policy;
+    Simulator simulator(randomSource, policy);
+
+    SECTION("Kill wumpus")
+    {
+        randomSource.SetNextInts({ 2, 11, 5, 16, 7, 9 });
+        policy.SetNextActions({ Action::Move(10), Action::Shoot({ 11 }) });
+        SimulationResults results = simulator.Run(1);
+        REQUIRE(results.GetGames() == 1);
+        REQUIRE(results.GetTurns() == 2);
+        REQUIRE(results.GetCount(Outcome::KilledWumpus) == 1);
+    }
+
+    SECTION("Eaten by wumpus at start")
+    {
+        randomSource.SetNextInts({ 2, 2, 5, 16, 7, 9, 3 });
+        SimulationResults results = simulator.Run(1);
+        REQUIRE(results.GetTurns() == 0);
+        REQUIRE(results.GetCount(Outcome::EatenByWumpus) == 1);
+    }
+
+    SECTION("Fell in pit")
+    {
+        randomSource.SetNextInts({ 2, 11, 5, 16, 10, 9 });
+        policy.SetNextActions({ Action::Move(10) });
+        SimulationResults results = simulator.Run(1);
+        REQUIRE(results.GetCount(Outcome::FellInPit) == 1);
+    }
+
+    SECTION("Shot self")
+    {
+        randomSource.SetNextInts({ 2, 20, 5, 16, 7, 9 });
+        policy.SetNextActions({ Action::Shoot({ 3, 4, 5, 1, 2 }) });
+        SimulationResults results = simulator.Run(1);
+        REQUIRE(results.GetCount(Outcome::ShotSelf) == 1);
+    }
+
+    SECTION("Out of arrows")
+    {
+        randomSource.SetNextInts({ 2, 20, 5, 16, 7, 9, 3, 3, 3, 3, 3 });
+        Action miss = Action::Shoot({ 10 });
+        policy.SetNextActions({ miss, miss, miss, miss, miss });
+        SimulationResults results = simulator.Run(1);
+        REQUIRE(results.GetTurns() == 5);
+        REQUIRE(results.GetCount(Outcome::OutOfArrows) == 1);
+    }
+
+    SECTION("Illegal action")
+    {
+        randomSource.SetNextInts({ 2, 20, 5, 16, 7, 9 });
+        policy.SetNextActions({ Action::Move(11) });
+        REQUIRE_THROWS_AS(simulator.Run(1), RoomsNotConnectedException);
+    }
+
+    SECTION("Illegal arrow path")
+    {
+        randomSource.SetNextInts({ 2, 20, 5, 16, 7, 9 });
+        policy.SetNextActions({ Action::Shoot({ 3, 2 }) });
+        REQUIRE_THROWS_AS(simulator.Run(1), ArrowDoubleBackException);
+    }
+
+    SECTION("Turn limit")
+    {
+        randomSource.SetNextInts({ 2, 20, 5, 16, 7, 9 });
+        SimulationResults results = simulator.Run(1, 3);
+        REQUIRE(results.GetTurns() == 3);
+        REQUIRE(results.GetCount(Outcome::TurnLimit) == 1);
+    }
+
+    SECTION("Merge")
+    {
+        SimulationResults results;
+        results.Record(Outcome::FellInPit, 4);
+        SimulationResults other;
+        other.Record(Outcome::FellInPit, 2);
+        other.Record(Outcome::KilledWumpus, 3);
+        results.Merge(other);
+        REQUIRE(results.GetGames() == 3);
+        REQUIRE(results.GetTurns() == 9);
+        REQUIRE(results.GetCount(Outcome::FellInPit) == 2);
+        REQUIRE(results.GetCount(Outcome::KilledWumpus) == 1);
+    }
+}
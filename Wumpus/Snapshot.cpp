@@ -0,0 +1,24 @@
+#include "Snapshot.h"
+
+#include "Exceptions.h"
+
+const uint16_t Snapshot::Magic;
+const uint16_t Snapshot::CurrentVersion;
+const int Snapshot::MaxRooms;
+const uint8_t Snapshot::PlayerAlive;
+const uint8_t Snapshot::WumpusAlive;
+
+void Snapshot::Validate(int numRooms) const
+{
+    if (m_magic != Magic || m_version != CurrentVersion || m_numRooms != numRooms)
+        throw SnapshotException();
+
+    // Zero is the room number of a game not yet started.
+    const uint16_t rooms[] = { m_initialPlayerRoom, m_initialWumpusRoom, m_playerRoom, m_wumpusRoom,
+        m_batRooms[0], m_batRooms[1], m_pitRooms[0], m_pitRooms[1], m_arrowRoom, m_prevArrowRoom };
+    for (uint16_t room : rooms)
+    {
+        if (room > numRooms)
+            throw SnapshotException();
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+using namespace std;
+
+// A game session frozen for storage: the Model's state and where the Interpreter is in
+// the conversation, so an idle session can be evicted from memory and restored later,
+// possibly in another process. Fixed size and trivially copyable, so it can be written
+// straight to a file or shared memory. Fields are in host byte order.
+//
+// The Map and RandomSource are not included: a session is restored onto a Model with
+// the same Map, and draws fresh random numbers from then on.
+class Snapshot
+{
+public:
+    static const uint16_t Magic = 0x5755;
+    static const uint16_t CurrentVersion = 1;
+
+    // Rooms are stored in 16 bits, so larger maps can't be saved.
+    static const int MaxRooms = 65535;
+
+    // Snapshot flags.
+    static const uint8_t PlayerAlive = 1;
+    static const uint8_t WumpusAlive = 2;
+
+    // Throws SnapshotException unless this is a current snapshot of a game on a map with
+    // numRooms rooms.
+    void Validate(int numRooms) const;
+
+    uint16_t m_magic;
+    uint16_t m_version;
+    uint16_t m_numRooms;
+    uint8_t m_interpreterState;
+    uint8_t m_flags;
+    uint16_t m_initialPlayerRoom;
+    uint16_t m_initialWumpusRoom;
+    uint16_t m_playerRoom;
+    uint16_t m_wumpusRoom;
+    uint16_t m_batRooms[2];
+    uint16_t m_pitRooms[2];
+    uint16_t m_arrowRoom;
+    uint16_t m_prevArrowRoom;
+    uint8_t m_arrowsRemaining;
+    uint8_t m_arrowMovesRemaining;
+    uint16_t m_reserved;
+};
+
+static_assert(sizeof(Snapshot) == 32, "Snapshot is a fixed-size record");
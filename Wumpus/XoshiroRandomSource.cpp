@@ -0,0 +1,106 @@
+#include "XoshiroRandomSource.h"
+
+namespace
+{
+    uint64_t RotateLeft(uint64_t x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    uint64_t SplitMix64(uint64_t& x)
+    {
+        uint64_t z = (x += 0x9e3779b97f4a7c15);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+    }
+}
+
+XoshiroRandomSource::XoshiroRandomSource(uint64_t seed)
+{
+    for (uint64_t& word : m_state)
+        word = SplitMix64(seed);
+}
+
+int XoshiroRandomSource::NextInt(int from, int to)
+{
+    return from + static_cast<int>(NextBelow(static_cast<uint32_t>(to - from) + 1));
+}
+
+void XoshiroRandomSource::NextInts(int from, int to, int* values, int count)
+{
+    uint32_t range = static_cast<uint32_t>(to - from) + 1;
+    for (int i = 0; i < count; ++i)
+        values[i] = from + static_cast<int>(NextBelow(range));
+}
+
+unique_ptr<RandomSource> XoshiroRandomSource::Clone() const
+{
+    return make_unique<XoshiroRandomSource>(*this);
+}
+
+XoshiroRandomSource::State XoshiroRandomSource::GetState() const
+{
+    return m_state;
+}
+
+void XoshiroRandomSource::SetState(const State& state)
+{
+    m_state = state;
+}
+
+uint32_t XoshiroRandomSource::NextBelow(uint32_t range)
+{
+    // Lemire's multiply-shift mapping of a 32-bit draw onto the range, rejecting the few
+    // low products that would otherwise bias it. The division only happens on the rare
+    // draws that land in the biased zone.
+    uint64_t product = (Next() >> 32) * range;
+    uint32_t low = static_cast<uint32_t>(product);
+    if (low < range)
+    {
+        uint32_t threshold = (0u - range) % range;
+        while (low < threshold)
+        {
+            product = (Next() >> 32) * range;
+            low = static_cast<uint32_t>(product);
+        }
+    }
+    return static_cast<uint32_t>(product >> 32);
+}
+
+uint64_t XoshiroRandomSource::Next()
+{
+    uint64_t result = RotateLeft(m_state[1] * 5, 7) * 9;
+    uint64_t t = m_state[1] << 17;
+
+    m_state[2] ^= m_state[0];
+    m_state[3] ^= m_state[1];
+    m_state[1] ^= m_state[2];
+    m_state[0] ^= m_state[3];
+    m_state[2] ^= t;
+    m_state[3] = RotateLeft(m_state[3], 45);
+
+    return result;
+}
+
+void XoshiroRandomSource::Jump()
+{
+    static const uint64_t JumpPolynomial[] = {
+        0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c
+    };
+
+    array<uint64_t, 4> jumped = {};
+    for (uint64_t word : JumpPolynomial)
+    {
+        for (int bit = 0; bit < 64; ++bit)
+        {
+            if (word & (uint64_t(1) << bit))
+            {
+                for (int i = 0; i < 4; ++i)
+                    jumped[i] ^= m_state[i];
+            }
+            Next();
+        }
+    }
+    m_state = jumped;
+}
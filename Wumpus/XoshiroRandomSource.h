@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "RandomSource.h"
+
+using namespace std;
+
+// xoshiro256** generator (Blackman and Vigna). Much faster than the standard library
+// engines, with a 2^256 - 1 period and a jump function for carving out independent
+// streams, e.g. one per worker thread.
+class XoshiroRandomSource : public RandomSource
+{
+public:
+    using State = array<uint64_t, 4>;
+
+    // The 64-bit seed is expanded to the full state with splitmix64.
+    explicit XoshiroRandomSource(uint64_t seed);
+
+    int NextInt(int from, int to) override;
+    void NextInts(int from, int to, int* values, int count) override;
+    unique_ptr<RandomSource> Clone() const override;
+
+    // The position in the stream. Restoring a saved state replays the same draws.
+    State GetState() const;
+    void SetState(const State& state);
+
+    uint64_t Next();
+
+    // Advances the stream by 2^128 draws. Calling Jump() n times on copies of one source
+    // gives n non-overlapping streams.
+    void Jump();
+
+private:
+    uint32_t NextBelow(uint32_t range);
+
+private:
+    State m_state;
+};
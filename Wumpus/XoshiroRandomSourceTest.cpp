@@ -0,0 +1,93 @@
+#include "catch.hpp"
+
+#include "stdtypes.h"
+#include "XoshiroRandomSource.h"
+
+TEST_CASE("XoshiroRandomSource")
+{
+    XoshiroRandomSource randomSource(42);
+
+    SECTION("Matches reference generator")
+    {
+        REQUIRE(randomSource.Next() == 0x15780b2e0c2ec716);
+        REQUIRE(randomSource.Next() == 0x6104d9866d113a7e);
+        REQUIRE(randomSource.Next() == 0xae17533239e499a1);
+    }
+
+    SECTION("Jump matches reference generator")
+    {
+        randomSource.Jump();
+        REQUIRE(randomSource.Next() == 0x50086ef83cbf4f4a);
+    }
+
+    SECTION("Same seed, same stream")
+    {
+        XoshiroRandomSource other(42);
+        for (int i = 0; i < 100; i++)
+        {
+            REQUIRE(randomSource.NextInt(1, 20) == other.NextInt(1, 20));
+        }
+    }
+
+    SECTION("Clone continues the stream")
+    {
+        randomSource.Next();
+        unique_ptr<RandomSource> clone = randomSource.Clone();
+        for (int i = 0; i < 100; i++)
+        {
+            REQUIRE(clone->NextInt(1, 20) == randomSource.NextInt(1, 20));
+        }
+    }
+
+    SECTION("Restoring state replays draws")
+    {
+        XoshiroRandomSource::State state = randomSource.GetState();
+        uint64_t first = randomSource.Next();
+        randomSource.Next();
+        randomSource.SetState(state);
+        REQUIRE(randomSource.Next() == first);
+    }
+
+    SECTION("Values within range")
+    {
+        for (int i = 0; i < 1000; i++)
+        {
+            int val = randomSource.NextInt(0, 3);
+            REQUIRE(val >= 0);
+            REQUIRE(val <= 3);
+        }
+    }
+
+    SECTION("Batch matches one at a time")
+    {
+        XoshiroRandomSource other(42);
+        array<int, 50> values;
+        randomSource.NextInts(1, 20, values.data(), static_cast<int>(values.size()));
+        for (int value : values)
+        {
+            REQUIRE(value == other.NextInt(1, 20));
+        }
+    }
+
+    SECTION("Single-value range")
+    {
+        REQUIRE(randomSource.NextInt(7, 7) == 7);
+    }
+}
+
+TEST_CASE("XoshiroRandomSource distribution", "[.]")
+{
+    XoshiroRandomSource randomSource(1);
+    array<int, 3> counts = { 0, 0, 0 };
+    for (int i = 0; i < 1000; i++)
+    {
+        int val = randomSource.NextInt(1, 3);
+        REQUIRE(val >= 1);
+        REQUIRE(val <= 3);
+        counts[val-1]++;
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        REQUIRE(counts[i] == Approx(333).epsilon(0.2));
+    }
+}
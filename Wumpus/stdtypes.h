@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
@@ -10,4 +11,5 @@ using namespace std;
 using ints2 = array<int, 2>;
 using ints3 = array<int, 3>;
 using intvec = vector<int>;
+using roommask = uint32_t;
 using strvec = vector<string>;